@@ -0,0 +1,87 @@
+// Position+Velocity integration over 100k entities: archetype SoA chunks vs
+// an array of "fat" game objects holding the same components.
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include "core/World.hpp"
+#include "core/components/Components.hpp"
+
+using namespace game;
+using namespace game::components;
+
+namespace {
+
+constexpr int ENTITY_COUNT = 100000;
+constexpr int ITERATIONS = 200;
+
+struct GameObject {
+    Position position;
+    Velocity velocity;
+    Health health;
+    Transform transform;
+    CollisionComponent collision;
+    PlayerComponent player;
+};
+
+template <typename F>
+auto measure(F&& f) -> double {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < ITERATIONS; ++i)
+        f();
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / (double(ITERATIONS) * ENTITY_COUNT);
+}
+
+} // namespace
+
+int main() {
+    std::vector<GameObject> objects(ENTITY_COUNT);
+    for (int i = 0; i < ENTITY_COUNT; ++i)
+        objects[i].velocity = {float(i % 7), float(i % 11)};
+
+    World world;
+    for (int i = 0; i < ENTITY_COUNT; ++i) {
+        auto e = world.createEntity();
+        world.add<Position>(e);
+        world.add<Velocity>(e, {float(i % 7), float(i % 11)});
+        world.add<Health>(e);
+        world.add<Transform>(e);
+        world.add<CollisionComponent>(e);
+        world.add<PlayerComponent>(e);
+    }
+
+    auto aos_ns = measure([&] {
+        for (auto& obj : objects) {
+            obj.position.x += obj.velocity.x * FIXED_TIMESTEP;
+            obj.position.y += obj.velocity.y * FIXED_TIMESTEP;
+        }
+    });
+
+    auto& query = world.query<Position, Velocity>();
+    auto soa_ns = measure([&] {
+        query.forEachChunk([](ChunkView view) {
+            auto* pos = view.write<Position>().data();
+            auto* vel = view.read<Velocity>().data();
+            auto count = view.count();
+            for (uint32_t i = 0; i < count; ++i) {
+                pos[i].x += vel[i].x * FIXED_TIMESTEP;
+                pos[i].y += vel[i].y * FIXED_TIMESTEP;
+            }
+        });
+    });
+
+    // keep the results observable
+    double checksum = 0;
+    for (auto& obj : objects)
+        checksum += obj.position.x;
+    query.each<const Position>([&](const Position& pos) { checksum -= pos.x; });
+
+    std::cout << "entities: " << ENTITY_COUNT << ", iterations: " << ITERATIONS << "\n";
+    std::cout << "array of structs : " << aos_ns << " ns/entity\n";
+    std::cout << "archetype chunks : " << soa_ns << " ns/entity\n";
+    std::cout << "speedup          : " << aos_ns / soa_ns << "x\n";
+    std::cout << "checksum         : " << checksum << std::endl;
+    return 0;
+}
@@ -0,0 +1,271 @@
+// player-vs-collider tests on a 150x150 cell arena: the linear scan
+// Game::update() used to do, against the broadphase structures. then
+// player-vs-player pairs while everyone moves: all pairs against the
+// dynamic tree, alone and, as CollisionSystem does it, next to a static
+// Bvh of the level colliders. last, solid tiles of a generated map as one collider per
+// cell against the cells merged into rectangles.
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "core/physics/Bvh.hpp"
+#include "core/physics/CollisionGrid.hpp"
+#include "core/physics/DynamicTree.hpp"
+#include "core/physics/SpatialHash.hpp"
+
+using namespace game;
+using namespace game::physics;
+
+namespace {
+
+constexpr float CELL_SIZE = 16.f;
+constexpr int ARENA_CELLS = 150;
+constexpr int COLLIDER_COUNT = 4000;
+constexpr int PLAYER_COUNT = 512;
+constexpr int ROUNDS = 200;
+// colliders for the BVH build timing, the level reload budget is a few ms
+constexpr int BUILD_COUNT = 10000;
+// moving players per room for the pair search, and ticks simulated
+constexpr int MOVING_COUNTS[] = {128, 512, 2048};
+constexpr int TICKS = 200;
+// per-tick player move, in pixels
+constexpr float STEP = 1.5f;
+// solid blobs of the generated tile map, up to BLOB_CELLS wide and high
+constexpr int BLOB_COUNT = 400;
+constexpr int BLOB_CELLS = 12;
+
+using Clock = std::chrono::steady_clock;
+
+auto randomBoxes(std::mt19937& rng, int count, float min_size, float max_size) -> std::vector<Aabb> {
+    std::uniform_real_distribution<float> pos(0.f, ARENA_CELLS * CELL_SIZE - max_size);
+    std::uniform_real_distribution<float> size(min_size, max_size);
+    std::vector<Aabb> boxes;
+    for (int i = 0; i < count; ++i)
+        boxes.push_back(Aabb::fromRect(pos(rng), pos(rng), size(rng), size(rng)));
+    return boxes;
+}
+
+// runs body ROUNDS times, reports nanoseconds per player
+template <typename Body>
+auto perPlayer(Body&& body) -> double {
+    auto start = Clock::now();
+    for (int round = 0; round < ROUNDS; ++round)
+        body();
+    std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+    return elapsed.count() / (double(ROUNDS) * PLAYER_COUNT);
+}
+
+struct PairResult {
+    double all_pairs_us = 0.0;
+    double tree_us = 0.0;
+    std::size_t pairs = 0;
+};
+
+// microseconds per tick to find the overlapping pairs of moving boxes, and
+// of moving boxes with the static ones if there are any
+auto movingPairs(std::mt19937& rng, int count, const std::vector<Aabb>& statics) -> PairResult {
+    auto boxes = randomBoxes(rng, count, 8.f, 16.f);
+    std::uniform_real_distribution<float> step(-STEP, STEP);
+    std::vector<std::vector<float>> moves(TICKS, std::vector<float>(2 * count));
+    for (auto& tick : moves) {
+        for (auto& v : tick)
+            v = step(rng);
+    }
+    auto moveAll = [&](std::vector<Aabb>& moving, int tick) {
+        for (int i = 0; i < count; ++i) {
+            auto dx = moves[tick][2 * i];
+            auto dy = moves[tick][2 * i + 1];
+            moving[i] = {moving[i].min_x + dx, moving[i].min_y + dy, moving[i].max_x + dx, moving[i].max_y + dy};
+        }
+    };
+
+    PairResult result;
+    auto moving = boxes;
+    std::size_t all_pairs = 0;
+    auto start = Clock::now();
+    for (int tick = 0; tick < TICKS; ++tick) {
+        moveAll(moving, tick);
+        for (int i = 0; i < count; ++i) {
+            for (int j = i + 1; j < count; ++j)
+                all_pairs += moving[i].overlaps(moving[j]);
+            for (const auto& collider : statics)
+                all_pairs += moving[i].overlaps(collider);
+        }
+    }
+    std::chrono::duration<double, std::micro> elapsed = Clock::now() - start;
+    result.all_pairs_us = elapsed.count() / TICKS;
+
+    moving = boxes;
+    Bvh static_bvh;
+    static_bvh.build({statics.data(), statics.size()});
+    DynamicTree tree;
+    std::vector<ProxyID> proxies;
+    for (int i = 0; i < count; ++i)
+        proxies.push_back(tree.insert(moving[i], uint32_t(i)));
+    start = Clock::now();
+    for (int tick = 0; tick < TICKS; ++tick) {
+        moveAll(moving, tick);
+        for (int i = 0; i < count; ++i)
+            tree.move(proxies[i], moving[i]);
+        tree.forEachPair([&](uint32_t, uint32_t) { ++result.pairs; });
+        for (int i = 0; i < count; ++i)
+            static_bvh.query(moving[i], [&](uint32_t) { ++result.pairs; });
+    }
+    elapsed = Clock::now() - start;
+    result.tree_us = elapsed.count() / TICKS;
+
+    if (result.pairs != all_pairs)
+        result.pairs = ~std::size_t{0};
+    return result;
+}
+
+// walls, rocks and water as overlapping blocks of cells, with ragged edges
+auto tileMap(std::mt19937& rng) -> CollisionGrid {
+    CollisionGrid grid(ARENA_CELLS, ARENA_CELLS, CELL_SIZE);
+    std::uniform_int_distribution<int> pos(0, ARENA_CELLS - 1);
+    std::uniform_int_distribution<int> size(1, BLOB_CELLS);
+    std::bernoulli_distribution ragged(0.1);
+    for (int blob = 0; blob < BLOB_COUNT; ++blob) {
+        auto x0 = pos(rng);
+        auto y0 = pos(rng);
+        auto x1 = std::min(x0 + size(rng), ARENA_CELLS);
+        auto y1 = std::min(y0 + size(rng), ARENA_CELLS);
+        for (auto y = y0; y < y1; ++y) {
+            for (auto x = x0; x < x1; ++x) {
+                auto edge = x == x0 || y == y0 || x == x1 - 1 || y == y1 - 1;
+                if (!edge || !ragged(rng))
+                    grid.set(x, y);
+            }
+        }
+    }
+    return grid;
+}
+
+} // namespace
+
+int main() {
+    std::mt19937 rng(42);
+    auto colliders = randomBoxes(rng, COLLIDER_COUNT, 16.f, 48.f);
+    auto players = randomBoxes(rng, PLAYER_COUNT, 8.f, 8.f);
+
+    std::size_t linear_hits = 0;
+    auto linear_ns = perPlayer([&] {
+        for (const auto& player : players) {
+            for (const auto& collider : colliders)
+                linear_hits += player.overlaps(collider);
+        }
+    });
+
+    SpatialHash hash(CELL_SIZE);
+    hash.rebuild({colliders.data(), colliders.size()});
+    std::size_t hash_hits = 0;
+    auto hash_ns = perPlayer([&] {
+        for (const auto& player : players)
+            hash.query(player, [&](uint32_t) { ++hash_hits; });
+    });
+
+    Bvh bvh;
+    bvh.build({colliders.data(), colliders.size()});
+    std::size_t bvh_hits = 0;
+    auto bvh_ns = perPlayer([&] {
+        for (const auto& player : players)
+            bvh.query(player, [&](uint32_t) { ++bvh_hits; });
+    });
+
+    auto build_boxes = randomBoxes(rng, BUILD_COUNT, 16.f, 48.f);
+    auto build_start = Clock::now();
+    Bvh built;
+    built.build({build_boxes.data(), build_boxes.size()});
+    std::chrono::duration<double, std::milli> build_ms = Clock::now() - build_start;
+
+    SpatialHash dynamic(CELL_SIZE);
+    auto rebuild_ns = perPlayer([&] { dynamic.rebuild({players.data(), players.size()}); });
+
+    if (hash_hits != linear_hits || bvh_hits != linear_hits) {
+        std::cerr << "broadphase mismatch: " << hash_hits << " (hash) and " << bvh_hits << " (bvh) hits, expected "
+                  << linear_hits << "\n";
+        return 1;
+    }
+
+    std::vector<PairResult> pair_results;
+    std::vector<PairResult> room_results;
+    for (auto count : MOVING_COUNTS) {
+        pair_results.push_back(movingPairs(rng, count, {}));
+        room_results.push_back(movingPairs(rng, count, colliders));
+        if (pair_results.back().pairs == ~std::size_t{0} || room_results.back().pairs == ~std::size_t{0}) {
+            std::cerr << "dynamic tree pair mismatch for " << count << " players\n";
+            return 1;
+        }
+    }
+
+    auto tiles = tileMap(rng);
+    std::vector<Aabb> cell_boxes;
+    for (int y = 0; y < tiles.height(); ++y) {
+        for (int x = 0; x < tiles.width(); ++x) {
+            if (tiles.solid(x, y))
+                cell_boxes.push_back(tiles.cellBox(x, y));
+        }
+    }
+    auto merge_start = Clock::now();
+    auto merged = tiles.solidRects();
+    std::chrono::duration<double, std::milli> merge_ms = Clock::now() - merge_start;
+
+    Bvh cell_bvh;
+    cell_bvh.build({cell_boxes.data(), cell_boxes.size()});
+    Bvh merged_bvh;
+    merged_bvh.build({merged.data(), merged.size()});
+    // narrow phase tests the broadphase hands out, and whether the player
+    // touches a solid tile at all, which both have to agree on
+    std::size_t cell_tests = 0;
+    std::size_t merged_tests = 0;
+    std::size_t cell_blocked = 0;
+    std::size_t merged_blocked = 0;
+    auto cell_ns = perPlayer([&] {
+        for (const auto& player : players) {
+            auto before = cell_tests;
+            cell_bvh.query(player, [&](uint32_t) { ++cell_tests; });
+            cell_blocked += cell_tests != before;
+        }
+    });
+    auto merged_ns = perPlayer([&] {
+        for (const auto& player : players) {
+            auto before = merged_tests;
+            merged_bvh.query(player, [&](uint32_t) { ++merged_tests; });
+            merged_blocked += merged_tests != before;
+        }
+    });
+    if (cell_blocked != merged_blocked) {
+        std::cerr << "merged tiles mismatch: " << merged_blocked << " blocked players, expected " << cell_blocked
+                  << "\n";
+        return 1;
+    }
+
+    std::cout << "colliders: " << COLLIDER_COUNT << ", players: " << PLAYER_COUNT << ", rounds: " << ROUNDS << "\n";
+    std::cout << "linear scan    : " << linear_ns << " ns per player\n";
+    std::cout << "spatial hash   : " << hash_ns << " ns per player (" << linear_ns / hash_ns << "x)\n";
+    std::cout << "static bvh     : " << bvh_ns << " ns per player (" << linear_ns / bvh_ns << "x)\n";
+    std::cout << "hash rebuild   : " << rebuild_ns << " ns per player\n";
+    std::cout << "bvh build      : " << build_ms.count() << " ms for " << BUILD_COUNT << " colliders, depth "
+              << built.depth() << "\n";
+    for (std::size_t i = 0; i < pair_results.size(); ++i) {
+        const auto& r = pair_results[i];
+        std::cout << "moving pairs   : " << MOVING_COUNTS[i] << " players, all pairs " << r.all_pairs_us
+                  << " us per tick, dynamic tree " << r.tree_us << " us per tick (" << r.all_pairs_us / r.tree_us
+                  << "x)\n";
+    }
+    for (std::size_t i = 0; i < room_results.size(); ++i) {
+        const auto& r = room_results[i];
+        std::cout << "room pairs     : " << MOVING_COUNTS[i] << " players and " << COLLIDER_COUNT
+                  << " colliders, all pairs " << r.all_pairs_us << " us per tick, tree and static bvh " << r.tree_us
+                  << " us per tick (" << r.all_pairs_us / r.tree_us << "x)\n";
+    }
+    std::cout << "tile colliders : " << cell_boxes.size() << " cells merged into " << merged.size() << " ("
+              << double(cell_boxes.size()) / merged.size() << "x fewer) in " << merge_ms.count() << " ms\n";
+    std::cout << "tile tests     : " << double(cell_tests) / merged_tests << "x fewer narrow phase tests, "
+              << cell_ns << " ns per player with cell colliders, " << merged_ns << " ns merged (" << cell_ns / merged_ns
+              << "x)\n";
+    std::cout << std::flush;
+    return 0;
+}
@@ -0,0 +1,233 @@
+// ECS micro-benchmark suite, for tracking regressions across commits:
+// entity create/destroy, component add/remove, query iteration and
+// structural changes recorded by parallel systems, at 1k to 1M entities.
+// prints one JSON document to stdout (or to --out <file>).
+//
+//     ecs_bench [--sizes 1000,10000] [--label <commit>] [--out results.json]
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/SystemManager.hpp"
+#include "core/components/Components.hpp"
+#include "json/json.hpp"
+
+using namespace game;
+using namespace game::components;
+
+namespace {
+
+// every case processes about this many entities per repetition set
+constexpr std::size_t WORK_PER_CASE = 4'000'000;
+constexpr int MIN_REPETITIONS = 3;
+// structural systems running at once in the parallel case
+constexpr int TAGGER_COUNT = 4;
+
+using Clock = std::chrono::steady_clock;
+
+struct Result {
+    double best_ns = 0.0;
+    double mean_ns = 0.0;
+    int repetitions = 0;
+};
+
+// runs setup() untimed then body() timed, reports nanoseconds per entity
+template <typename Setup, typename Body>
+auto measure(std::size_t entities, Setup&& setup, Body&& body) -> Result {
+    auto repetitions = std::max<int>(MIN_REPETITIONS, static_cast<int>(WORK_PER_CASE / entities));
+    Result result;
+    result.repetitions = repetitions;
+    result.best_ns = 1e300;
+    double total = 0.0;
+    for (int i = 0; i < repetitions; ++i) {
+        setup();
+        auto start = Clock::now();
+        body();
+        std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+        auto per_entity = elapsed.count() / double(entities);
+        result.best_ns = std::min(result.best_ns, per_entity);
+        total += per_entity;
+    }
+    result.mean_ns = total / repetitions;
+    return result;
+}
+
+void populate(World& world, std::size_t count, std::vector<EntityID>* out = nullptr) {
+    for (std::size_t i = 0; i < count; ++i) {
+        auto e = world.createEntity();
+        world.add<Position>(e, {float(i), 0.f});
+        world.add<Velocity>(e, {1.f, 0.5f});
+        if (out)
+            out->push_back(e);
+    }
+}
+
+auto benchCreateDestroy(std::size_t count) -> Result {
+    World world;
+    std::vector<EntityID> entities;
+    entities.reserve(count);
+    return measure(
+        count, [&] { entities.clear(); },
+        [&] {
+            for (std::size_t i = 0; i < count; ++i)
+                entities.push_back(world.createEntity());
+            for (auto e : entities)
+                world.destroyEntity(e);
+        });
+}
+
+auto benchAddRemove(std::size_t count) -> Result {
+    World world;
+    std::vector<EntityID> entities;
+    populate(world, count, &entities);
+    return measure(
+        count, [] {},
+        [&] {
+            for (auto e : entities)
+                world.add<Health>(e);
+            for (auto e : entities)
+                world.remove<Health>(e);
+        });
+}
+
+auto benchIterate(std::size_t count) -> Result {
+    World world;
+    populate(world, count);
+    auto& query = world.query<Position, Velocity>();
+    return measure(
+        count, [] {},
+        [&] {
+            query.each<Position, const Velocity>([](Position& p, const Velocity& v) {
+                p.x += v.x * FIXED_TIMESTEP;
+                p.y += v.y * FIXED_TIMESTEP;
+            });
+        });
+}
+
+// tags (or untags) every TAGGER_COUNT-th chunk of the query through its
+// command buffer; taggers only read, so they all run at the same time
+class Tagger : public System {
+public:
+    explicit Tagger(int slot) : System("Tagger"), m_slot(slot) { reads<Position>(); }
+
+    void init(World& world) override { m_query = &world.query<Position>(); }
+
+    void update(World& world, float /*dt*/) override {
+        auto tag = world.tick() % 2 == 0;
+        int index = 0;
+        m_query->forEachChunk([&](ChunkView view) {
+            if (index++ % TAGGER_COUNT != m_slot)
+                return;
+            for (auto e : view.entities()) {
+                if (tag)
+                    commands().add<Health>(e);
+                else
+                    commands().remove<Health>(e);
+            }
+        });
+    }
+
+private:
+    int m_slot;
+    Query* m_query = nullptr;
+};
+
+auto benchParallelStructural(std::size_t count, ThreadPool& pool) -> Result {
+    World world;
+    populate(world, count);
+    SystemManager systems(world, &pool);
+    for (int i = 0; i < TAGGER_COUNT; ++i)
+        systems.add<Tagger>(i);
+    Tick tick = 0;
+    return measure(
+        count, [&] { world.setTick(tick++); }, [&] { systems.update(FIXED_TIMESTEP); });
+}
+
+auto toJson(const Result& result) -> nlohmann::json {
+    return {
+        {"ns_per_entity", result.best_ns},
+        {"mean_ns_per_entity", result.mean_ns},
+        {"repetitions", result.repetitions},
+    };
+}
+
+auto parseSizes(const std::string& list) -> std::vector<std::size_t> {
+    std::vector<std::size_t> sizes;
+    std::size_t start = 0;
+    while (start < list.size()) {
+        auto end = list.find(',', start);
+        if (end == std::string::npos)
+            end = list.size();
+        sizes.push_back(std::stoul(list.substr(start, end - start)));
+        start = end + 1;
+    }
+    return sizes;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::vector<std::size_t> sizes = {1'000, 10'000, 100'000, 1'000'000};
+    std::string label;
+    std::string out_path;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--sizes" && i + 1 < argc)
+            sizes = parseSizes(argv[++i]);
+        else if (arg == "--label" && i + 1 < argc)
+            label = argv[++i];
+        else if (arg == "--out" && i + 1 < argc)
+            out_path = argv[++i];
+        else {
+            std::cerr << "usage: " << argv[0] << " [--sizes 1000,10000] [--label <name>] [--out <file>]\n";
+            return 2;
+        }
+    }
+
+    ThreadPool pool;
+    nlohmann::json results = nlohmann::json::array();
+    for (auto size : sizes) {
+        if (size == 0 || size > MAX_ENTITIES) {
+            std::cerr << "entity count must be in [1, " << MAX_ENTITIES << "]\n";
+            return 2;
+        }
+        results.push_back({
+            {"entities", size},
+            {"create_destroy", toJson(benchCreateDestroy(size))},
+            {"add_remove", toJson(benchAddRemove(size))},
+            {"query_iterate", toJson(benchIterate(size))},
+            {"parallel_structural", toJson(benchParallelStructural(size, pool))},
+        });
+    }
+
+    nlohmann::json report = {
+        {"benchmark", "ecs_bench"},
+        {"label", label},
+        {"threads", pool.workerCount() + 1},
+        {"hardware_concurrency", std::thread::hardware_concurrency()},
+#ifdef NDEBUG
+        {"optimized", true},
+#else
+        {"optimized", false},
+#endif
+        {"results", results},
+    };
+
+    if (out_path.empty()) {
+        std::cout << report.dump(2) << std::endl;
+    }
+    else {
+        std::ofstream out(out_path);
+        out << report.dump(2) << '\n';
+        if (!out) {
+            std::cerr << "could not write " << out_path << "\n";
+            return 1;
+        }
+    }
+    return 0;
+}
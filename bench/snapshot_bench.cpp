@@ -0,0 +1,76 @@
+// capture/restore cost of a full room (MAX_PLAYERS_PER_ROOM players plus
+// projectiles) into a rollback ring, against the 50 us capture budget.
+
+#include <chrono>
+#include <iostream>
+
+#include "core/Snapshot.hpp"
+#include "core/World.hpp"
+#include "core/components/Components.hpp"
+
+using namespace game;
+using namespace game::components;
+
+namespace {
+
+constexpr int PROJECTILES_PER_PLAYER = 4;
+// one second of history at the default tick rate
+constexpr std::size_t RING_SLOTS = DEFAULT_TICK_RATE;
+constexpr int ITERATIONS = 10000;
+constexpr double CAPTURE_BUDGET_US = 50.0;
+
+void populate(World& world) {
+    for (int i = 0; i < MAX_PLAYERS_PER_ROOM; ++i) {
+        auto player = world.createEntity();
+        world.add<Position>(player, {float(i) * 16.f, 64.f});
+        world.add<Velocity>(player);
+        world.add<Health>(player);
+        world.add<Transform>(player);
+        world.add<CollisionComponent>(player, {0.f, 0.f, 16.f, 16.f, false});
+        world.add<PlayerComponent>(player, {PlayerID(i), 255, 255, 255});
+        world.add<InputComponent>(player);
+
+        for (int j = 0; j < PROJECTILES_PER_PLAYER; ++j) {
+            auto projectile = world.createEntity();
+            world.add<Position>(projectile);
+            world.add<Velocity>(projectile, {300.f, 0.f});
+            world.add<CollisionComponent>(projectile, {0.f, 0.f, 4.f, 4.f, false});
+        }
+    }
+}
+
+} // namespace
+
+int main() {
+    World world;
+    populate(world);
+
+    SnapshotRing ring(RING_SLOTS);
+    // first pass sizes the slot buffers
+    for (std::size_t i = 0; i < RING_SLOTS; ++i) {
+        world.setTick(i);
+        ring.capture(world);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < ITERATIONS; ++i) {
+        world.setTick(RING_SLOTS + i);
+        ring.capture(world);
+    }
+    std::chrono::duration<double, std::micro> capture = std::chrono::steady_clock::now() - start;
+
+    auto last = world.tick();
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < ITERATIONS; ++i)
+        ring.restore(world, last - i % RING_SLOTS);
+    std::chrono::duration<double, std::micro> restore = std::chrono::steady_clock::now() - start;
+
+    auto capture_us = capture.count() / ITERATIONS;
+    std::cout << "entities        : " << world.entityCount() << " (" << MAX_PLAYERS_PER_ROOM << " players)\n";
+    std::cout << "snapshot size   : " << ring.bytes(last) / 1024.0 << " KiB\n";
+    std::cout << "capture         : " << capture_us << " us\n";
+    std::cout << "restore         : " << restore.count() / ITERATIONS << " us\n";
+    std::cout << "capture budget  : " << CAPTURE_BUDGET_US << " us "
+              << (capture_us < CAPTURE_BUDGET_US ? "(ok)" : "(EXCEEDED)") << std::endl;
+    return capture_us < CAPTURE_BUDGET_US ? 0 : 1;
+}
@@ -0,0 +1,78 @@
+// add+remove of a high-churn component on entities that also carry the usual
+// archetype components: sparse-set pool vs moving the row between archetypes.
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include "core/World.hpp"
+#include "core/components/Components.hpp"
+
+using namespace game;
+using namespace game::components;
+
+namespace {
+
+constexpr int ENTITY_COUNT = 10000;
+constexpr int ROUNDS = 50;
+
+// same data as InputComponent, but stored in the archetype chunks
+struct ArchetypeInput {
+    uint8_t buttons = 0;
+    SequenceNumber sequence = 0;
+};
+
+} // namespace
+
+template <>
+struct game::ComponentTraits<ArchetypeInput> {
+    static constexpr ComponentTypeID id = 32;
+    static constexpr const char* name = "ArchetypeInput";
+};
+
+namespace {
+
+auto makeEntities(World& world) -> std::vector<EntityID> {
+    std::vector<EntityID> entities;
+    for (int i = 0; i < ENTITY_COUNT; ++i) {
+        auto e = world.createEntity();
+        world.add<Position>(e);
+        world.add<Velocity>(e);
+        world.add<Health>(e);
+        world.add<Transform>(e);
+        world.add<CollisionComponent>(e);
+        entities.push_back(e);
+    }
+    return entities;
+}
+
+template <typename T>
+auto churn(World& world, const std::vector<EntityID>& entities) -> double {
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < ROUNDS; ++round) {
+        for (auto e : entities)
+            world.add<T>(e, {uint8_t(round), SequenceNumber(round)});
+        for (auto e : entities)
+            world.remove<T>(e);
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / (double(ROUNDS) * ENTITY_COUNT);
+}
+
+} // namespace
+
+int main() {
+    World sparse_world;
+    auto sparse_entities = makeEntities(sparse_world);
+    auto sparse_ns = churn<InputComponent>(sparse_world, sparse_entities);
+
+    World archetype_world;
+    auto archetype_entities = makeEntities(archetype_world);
+    auto archetype_ns = churn<ArchetypeInput>(archetype_world, archetype_entities);
+
+    std::cout << "entities: " << ENTITY_COUNT << ", rounds: " << ROUNDS << "\n";
+    std::cout << "archetype move : " << archetype_ns << " ns per add+remove\n";
+    std::cout << "sparse pool    : " << sparse_ns << " ns per add+remove\n";
+    std::cout << "speedup        : " << archetype_ns / sparse_ns << "x" << std::endl;
+    return 0;
+}
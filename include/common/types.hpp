@@ -6,13 +6,13 @@
 
 // Forward declarations for component types
 namespace game::components {
-    class Position;
-    class Velocity;
-    class Health;
-    class PlayerComponent;
-    class Transform;
-    class InputComponent;
-    class CollisionComponent;
+    struct Position;
+    struct Velocity;
+    struct Health;
+    struct PlayerComponent;
+    struct Transform;
+    struct InputComponent;
+    struct CollisionComponent;
 }
 
 namespace game {
@@ -27,6 +27,7 @@ using Tick = uint64_t;
 
 // Component Type IDs - MUST BE CONSISTENT BETWEEN SERVER AND CLIENT
 // These are fixed IDs to ensure network compatibility
+// (checked at handshake through COMPONENT_SCHEMA_HASH, see core/components/Components.hpp)
 namespace ComponentType {
     constexpr ComponentTypeID Position = 0;
     constexpr ComponentTypeID Velocity = 1;
@@ -37,10 +38,33 @@ namespace ComponentType {
     constexpr ComponentTypeID CollisionComponent = 6;
 }
 
+// Event Type IDs, local to a process (events are not sent over the network)
+using EventTypeID = uint32_t;
+namespace EventType {
+    constexpr EventTypeID Damage = 0;
+    constexpr EventTypeID Death = 1;
+    constexpr EventTypeID Pickup = 2;
+    constexpr EventTypeID Collision = 3;
+}
+
+// Resource Type IDs, room-wide singletons stored on the World
+using ResourceTypeID = uint32_t;
+namespace ResourceType {
+    constexpr ResourceTypeID LevelBounds = 0;
+    constexpr ResourceTypeID SpawnTable = 1;
+    constexpr ResourceTypeID Timers = 2;
+    constexpr ResourceTypeID CollisionGrid = 3;
+}
+
 // Network types
 using PacketID = uint16_t;
 using SequenceNumber = uint32_t;
 
+// true if sequence a is newer than b, tolerating wrap-around
+constexpr auto sequenceGreaterThan(SequenceNumber a, SequenceNumber b) -> bool {
+    return a != b && static_cast<SequenceNumber>(a - b) < 0x80000000u;
+}
+
 // Constants
 constexpr EntityID INVALID_ENTITY = std::numeric_limits<EntityID>::max();
 constexpr PlayerID INVALID_PLAYER = std::numeric_limits<PlayerID>::max();
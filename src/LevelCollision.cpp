@@ -0,0 +1,25 @@
+#include "LevelCollision.hpp"
+
+#include <stdexcept>
+
+auto compileCollisionGrid(const ldtk::Level& level, const std::vector<SolidTile>& solid)
+    -> game::physics::CollisionGrid {
+    if (solid.empty())
+        return {};
+
+    auto& first = level.getLayer(solid.front().layer);
+    auto& size = first.getGridSize();
+    auto& offset = first.getOffset();
+    game::physics::CollisionGrid grid(size.x, size.y, static_cast<float>(first.getCellSize()),
+                                      static_cast<float>(offset.x), static_cast<float>(offset.y));
+
+    for (auto& tile : solid) {
+        auto& layer = level.getLayer(tile.layer);
+        if (!(layer.getGridSize() == size) || layer.getCellSize() != first.getCellSize() ||
+            !(layer.getOffset() == offset))
+            throw std::invalid_argument("IntGrid layer " + tile.layer + " doesn't match the collision grid");
+        for (auto& pos : layer.getIntGridValPositions(tile.value))
+            grid.set(pos.x, pos.y);
+    }
+    return grid;
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <LDtkLoader/Project.hpp>
+
+#include "core/physics/CollisionGrid.hpp"
+
+// an IntGrid value that blocks movement
+struct SolidTile {
+    std::string layer;
+    std::string value;
+};
+
+// compiles the solid IntGrid cells of a level into a collision bitset, read
+// once per value through LDtk's position lists instead of cell by cell.
+// the layers have to share one grid (size, cell size and offset).
+auto compileCollisionGrid(const ldtk::Level& level, const std::vector<SolidTile>& solid)
+    -> game::physics::CollisionGrid;
@@ -0,0 +1,53 @@
+#include "LevelPrefabs.hpp"
+
+using game::components::CollisionComponent;
+using game::components::Position;
+
+auto LevelPrefabs::get(const ldtk::World& world, const std::string& name) -> const game::Prefab& {
+    return compile(world, name).prefab;
+}
+
+auto LevelPrefabs::compile(const ldtk::World& world, const std::string& name) -> const Compiled& {
+    auto it = m_prefabs.find(name);
+    if (it != m_prefabs.end())
+        return it->second;
+
+    auto& def = world.getEntityDef(name);
+    // the shape is relative to the pivot, where LDtk places the entity
+    CollisionComponent shape;
+    shape.offset_x = -def.pivot.x * static_cast<float>(def.size.x);
+    shape.offset_y = -def.pivot.y * static_cast<float>(def.size.y);
+    shape.width = static_cast<float>(def.size.x);
+    shape.height = static_cast<float>(def.size.y);
+    shape.is_static = def.hasTag("region");
+
+    game::Prefab prefab(name);
+    prefab.set(Position{}).set(shape);
+    return m_prefabs.emplace(name, Compiled{std::move(prefab), shape}).first->second;
+}
+
+auto LevelPrefabs::instantiate(game::World& ecs, const ldtk::World& world, const ldtk::Layer& layer,
+                               const std::string& name) -> std::vector<game::EntityID> {
+    auto& compiled = compile(world, name);
+    auto& instances = layer.getEntitiesByName(name);
+
+    // gather the per-instance columns, then hand them over in one go
+    std::vector<Position> positions;
+    std::vector<CollisionComponent> shapes;
+    positions.reserve(instances.size());
+    shapes.reserve(instances.size());
+    for (const ldtk::Entity& entity : instances) {
+        positions.push_back({static_cast<float>(entity.getPosition().x), static_cast<float>(entity.getPosition().y)});
+        // instances may be resized in the editor
+        auto shape = compiled.shape;
+        shape.width = static_cast<float>(entity.getSize().x);
+        shape.height = static_cast<float>(entity.getSize().y);
+        shape.offset_x = -entity.getPivot().x * shape.width;
+        shape.offset_y = -entity.getPivot().y * shape.height;
+        shapes.push_back(shape);
+    }
+
+    std::vector<game::EntityID> entities(instances.size());
+    ecs.instantiate(compiled.prefab, {entities.data(), entities.size()}, positions.data(), shapes.data());
+    return entities;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <LDtkLoader/Project.hpp>
+
+#include "core/World.hpp"
+#include "core/components/Components.hpp"
+
+// ECS prefabs compiled from the LDtk entity definitions, so a level's
+// entities of one type are created with a single archetype bulk insert.
+// LDtkLoader doesn't expose field defaults, a prefab holds what the
+// EntityDef itself defines (size and pivot); per-instance values come from
+// the level. definitions tagged "region" are static colliders.
+class LevelPrefabs {
+public:
+    // drops the compiled prefabs, to be called when the project is reloaded
+    void clear() { m_prefabs.clear(); }
+
+    // prefab of the named EntityDef, compiled on first use
+    auto get(const ldtk::World& world, const std::string& name) -> const game::Prefab&;
+
+    // creates an ECS entity for every entity of that definition in the layer
+    auto instantiate(game::World& ecs, const ldtk::World& world, const ldtk::Layer& layer,
+                     const std::string& name) -> std::vector<game::EntityID>;
+
+private:
+    struct Compiled {
+        game::Prefab prefab;
+        game::components::CollisionComponent shape;
+    };
+
+    auto compile(const ldtk::World& world, const std::string& name) -> const Compiled&;
+
+    std::map<std::string, Compiled> m_prefabs;
+};
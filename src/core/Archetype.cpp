@@ -0,0 +1,204 @@
+#include "core/Archetype.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace game {
+
+namespace {
+
+auto alignUp(std::size_t value, std::size_t align) -> std::size_t {
+    return (value + align - 1) & ~(align - 1);
+}
+
+// computes column offsets for the given row capacity, returns the bytes used
+// in the hot and in the cold block
+auto layoutColumns(std::pmr::vector<Column>& columns, uint32_t capacity) -> std::pair<std::size_t, std::size_t> {
+    std::size_t hot = 2 * sizeof(Tick) * columns.size() + sizeof(EntityID) * capacity;
+    std::size_t cold = 0;
+    for (auto& col : columns) {
+        auto& offset = col.cold ? cold : hot;
+        offset = alignUp(offset, col.info->align);
+        col.offset = offset;
+        offset += col.info->size * capacity;
+        offset = alignUp(offset, alignof(Tick));
+        col.ticks_offset = offset;
+        offset += sizeof(Tick) * capacity;
+    }
+    return {hot, cold};
+}
+
+} // namespace
+
+Archetype::Archetype(const Signature& signature, ChunkAllocator& allocator)
+: m_signature(signature),
+  m_allocator(allocator),
+  m_columns(allocator.resource()),
+  m_chunks(allocator.resource()) {
+    m_column_index.fill(-1);
+
+    std::size_t row_size = sizeof(EntityID);
+    std::size_t cold_row_size = 0;
+    for (ComponentTypeID id = 0; id < MAX_COMPONENTS; ++id) {
+        if (!signature.test(id))
+            continue;
+        const auto& info = ComponentRegistry::get(id);
+        if (info.storage == StorageMode::Sparse)
+            throw std::invalid_argument(std::string("component ") + info.name + " is not archetype-stored");
+        if (info.align > CHUNK_ALIGN)
+            throw std::invalid_argument(std::string("component ") + info.name + " is over-aligned");
+        m_column_index[id] = static_cast<int8_t>(m_columns.size());
+        auto cold = info.storage == StorageMode::Cold;
+        m_columns.push_back({&info, 0, 0, cold});
+        m_trivial = m_trivial && info.trivial;
+        m_has_cold = m_has_cold || cold;
+        (cold ? cold_row_size : row_size) += info.size + sizeof(Tick);
+    }
+    m_entities_offset = 2 * sizeof(Tick) * m_columns.size();
+
+    // start from the unpadded estimate and shrink until alignment padding fits
+    m_capacity = static_cast<uint32_t>((CHUNK_SIZE - m_entities_offset) / row_size);
+    if (cold_row_size > 0)
+        m_capacity = std::min(m_capacity, static_cast<uint32_t>(CHUNK_SIZE / cold_row_size));
+    auto fits = [this] {
+        auto [hot, cold] = layoutColumns(m_columns, m_capacity);
+        return hot <= CHUNK_SIZE && cold <= CHUNK_SIZE;
+    };
+    while (m_capacity > 0 && !fits())
+        --m_capacity;
+    if (m_capacity == 0)
+        throw std::invalid_argument("archetype row does not fit in a chunk");
+}
+
+Archetype::~Archetype() {
+    clear();
+}
+
+void Archetype::clear() {
+    for (auto& chunk : m_chunks) {
+        for (const auto& col : m_columns) {
+            if (col.info->trivial)
+                continue;
+            auto* data = block(chunk, col) + col.offset;
+            for (uint32_t row = 0; row < chunk.count; ++row)
+                col.info->destroy(data + row * col.info->size);
+        }
+        releaseChunk(chunk);
+    }
+    m_chunks.clear();
+    m_size = 0;
+}
+
+void Archetype::save(SnapshotBuffer& out) const {
+    if (!m_trivial && m_size > 0) {
+        for (const auto& col : m_columns) {
+            if (!col.info->trivial)
+                throw std::invalid_argument(std::string("component ") + col.info->name +
+                                            " is not trivially copyable");
+        }
+    }
+    out.write(static_cast<uint32_t>(m_chunks.size()));
+    // the whole chunk: with the SoA layout every column has unused rows at
+    // its end, skipping them isn't worth a copy per column
+    for (const auto& chunk : m_chunks) {
+        out.write(chunk.count);
+        out.write(chunk.data, CHUNK_SIZE);
+        if (m_has_cold)
+            out.write(chunk.cold, CHUNK_SIZE);
+    }
+}
+
+void Archetype::load(SnapshotBuffer& in) {
+    // non-trivial archetypes were saved empty, their current rows still need destroying
+    if (!m_trivial)
+        clear();
+
+    auto chunk_count = in.read<uint32_t>();
+    while (m_chunks.size() > chunk_count) {
+        releaseChunk(m_chunks.back());
+        m_chunks.pop_back();
+    }
+    while (m_chunks.size() < chunk_count)
+        m_chunks.push_back(allocateChunk());
+
+    m_size = 0;
+    for (auto& chunk : m_chunks) {
+        chunk.count = in.read<uint32_t>();
+        in.read(chunk.data, CHUNK_SIZE);
+        if (m_has_cold)
+            in.read(chunk.cold, CHUNK_SIZE);
+        m_size += chunk.count;
+    }
+}
+
+auto Archetype::pushRow(EntityID entity) -> std::pair<uint32_t, uint32_t> {
+    if (m_chunks.empty() || m_chunks.back().count == m_capacity)
+        newChunk();
+
+    auto chunk_index = static_cast<uint32_t>(m_chunks.size() - 1);
+    auto& chunk = m_chunks.back();
+    auto row = chunk.count++;
+    entities(chunk)[row] = entity;
+    ++m_size;
+    return {chunk_index, row};
+}
+
+auto Archetype::removeRow(uint32_t chunk_index, uint32_t row, bool destroy) -> EntityID {
+    auto& chunk = m_chunks[chunk_index];
+    if (destroy) {
+        for (const auto& col : m_columns) {
+            if (!col.info->trivial)
+                col.info->destroy(block(chunk, col) + col.offset + row * col.info->size);
+        }
+    }
+
+    auto& last = m_chunks.back();
+    auto last_row = last.count - 1;
+    auto moved = INVALID_ENTITY;
+    if (&last != &chunk || last_row != row) {
+        // fill the hole with the last row of the archetype
+        for (const auto& col : m_columns) {
+            auto size = col.info->size;
+            auto* dst = block(chunk, col) + col.offset + row * size;
+            auto* src = block(last, col) + col.offset + last_row * size;
+            if (col.info->trivial)
+                std::memcpy(dst, src, size);
+            else
+                col.info->relocate(dst, src);
+            stamp(chunk, col.info->id, row, rowTick(last, col.info->id, last_row));
+        }
+        moved = entities(last)[last_row];
+        entities(chunk)[row] = moved;
+    }
+
+    --m_size;
+    if (--last.count == 0) {
+        releaseChunk(last);
+        m_chunks.pop_back();
+    }
+    return moved;
+}
+
+auto Archetype::newChunk() -> Chunk& {
+    m_chunks.push_back(allocateChunk());
+    std::fill_n(reinterpret_cast<Tick*>(m_chunks.back().data), 2 * m_columns.size(), Tick{0});
+    return m_chunks.back();
+}
+
+auto Archetype::allocateChunk() -> Chunk {
+    Chunk chunk;
+    chunk.data = m_allocator.allocate();
+    if (m_has_cold)
+        chunk.cold = m_allocator.allocate();
+    return chunk;
+}
+
+void Archetype::releaseChunk(const Chunk& chunk) {
+    m_allocator.release(chunk.data);
+    if (chunk.cold)
+        m_allocator.release(chunk.cold);
+}
+
+} // namespace game
@@ -0,0 +1,171 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+#include "core/Chunk.hpp"
+#include "core/ComponentRegistry.hpp"
+#include "core/Snapshot.hpp"
+
+namespace game {
+
+struct Column {
+    const ComponentInfo* info = nullptr;
+    // byte offsets of the column data and of its per-row change ticks inside
+    // every chunk of the archetype
+    std::size_t offset = 0;
+    std::size_t ticks_offset = 0;
+    // lives in the chunk's cold block, offsets are relative to it
+    bool cold = false;
+};
+
+// all entities sharing one signature, packed into 16 KiB chunks.
+// a chunk is laid out structure-of-arrays:
+//     [Tick x 2 x columns][EntityID x capacity][A x capacity][Tick x capacity][B x capacity]...
+// the chunk header holds two ticks per column: the last tick any row was
+// written on, so change queries can skip whole chunks, and the last tick the
+// whole column was written on, so bulk writes don't have to touch every row.
+// the tick array after each column holds the last single-row write.
+// StorageMode::Cold columns are laid out the same way in a second block per
+// chunk, so the hot block only holds what per-tick loops read:
+//     [C x capacity][Tick x capacity]...
+// rows are kept dense across the whole archetype: removing a row moves the
+// very last row of the archetype into the hole.
+// chunks and bookkeeping come from the allocator's memory resource.
+class Archetype {
+public:
+    Archetype(const Signature& signature, ChunkAllocator& allocator);
+    Archetype(const Archetype&) = delete;
+    auto operator=(const Archetype&) -> Archetype& = delete;
+    ~Archetype();
+
+    auto signature() const -> const Signature& { return m_signature; }
+    auto capacity() const -> uint32_t { return m_capacity; }
+    auto size() const -> std::size_t { return m_size; }
+    auto columns() const -> const std::pmr::vector<Column>& { return m_columns; }
+    // every component is trivially destructible
+    auto trivial() const -> bool { return m_trivial; }
+
+    auto chunks() -> std::pmr::vector<Chunk>& { return m_chunks; }
+    auto chunks() const -> const std::pmr::vector<Chunk>& { return m_chunks; }
+
+    auto hasColumn(ComponentTypeID id) const -> bool { return m_column_index[id] >= 0; }
+    // id must be one of the archetype columns, see hasColumn()
+    auto column(ComponentTypeID id) const -> const Column& {
+        assert(hasColumn(id));
+        return m_columns[m_column_index[id]];
+    }
+
+    auto entities(const Chunk& chunk) const -> EntityID* {
+        return reinterpret_cast<EntityID*>(chunk.data + m_entities_offset);
+    }
+    auto columnData(const Chunk& chunk, ComponentTypeID id) const -> std::byte* {
+        const auto& col = column(id);
+        return block(chunk, col) + col.offset;
+    }
+    auto componentData(const Chunk& chunk, ComponentTypeID id, uint32_t row) const -> void* {
+        const auto& col = column(id);
+        return block(chunk, col) + col.offset + row * col.info->size;
+    }
+    template <typename T>
+    auto columnData(const Chunk& chunk) const -> T* {
+        return reinterpret_cast<T*>(columnData(chunk, componentId<T>()));
+    }
+
+    // change tracking, id must be one of the archetype columns
+    auto chunkTick(const Chunk& chunk, ComponentTypeID id) const -> Tick& {
+        assert(hasColumn(id));
+        return reinterpret_cast<Tick*>(chunk.data)[m_column_index[id]];
+    }
+    auto bulkTick(const Chunk& chunk, ComponentTypeID id) const -> Tick& {
+        assert(hasColumn(id));
+        return reinterpret_cast<Tick*>(chunk.data)[m_columns.size() + m_column_index[id]];
+    }
+    auto rowTick(const Chunk& chunk, ComponentTypeID id, uint32_t row) const -> Tick {
+        const auto& col = column(id);
+        auto tick = reinterpret_cast<const Tick*>(block(chunk, col) + col.ticks_offset)[row];
+        auto bulk = bulkTick(chunk, id);
+        return tick > bulk ? tick : bulk;
+    }
+    void stamp(const Chunk& chunk, ComponentTypeID id, uint32_t row, Tick tick) const {
+        const auto& col = column(id);
+        reinterpret_cast<Tick*>(block(chunk, col) + col.ticks_offset)[row] = tick;
+        auto& chunk_tick = chunkTick(chunk, id);
+        if (chunk_tick < tick)
+            chunk_tick = tick;
+    }
+    void stampRows(const Chunk& chunk, ComponentTypeID id, uint32_t first, uint32_t count, Tick tick) const {
+        const auto& col = column(id);
+        std::fill_n(reinterpret_cast<Tick*>(block(chunk, col) + col.ticks_offset) + first, count, tick);
+        auto& chunk_tick = chunkTick(chunk, id);
+        if (chunk_tick < tick)
+            chunk_tick = tick;
+    }
+    void stampAll(const Chunk& chunk, ComponentTypeID id, Tick tick) const {
+        bulkTick(chunk, id) = tick;
+        auto& chunk_tick = chunkTick(chunk, id);
+        if (chunk_tick < tick)
+            chunk_tick = tick;
+    }
+
+    // appends an uninitialized row for the entity, returns {chunk index, row}
+    auto pushRow(EntityID entity) -> std::pair<uint32_t, uint32_t>;
+    // appends uninitialized rows for all the entities, topping up the last
+    // chunk before allocating new ones. fill(chunk_index, first_row, count)
+    // is called once per chunk the rows landed in, in entity order.
+    template <typename Fn>
+    void pushRows(const EntityID* entities, std::size_t count, Fn&& fill);
+    // removes a row, destroying its components first when destroy is true
+    // (otherwise they must have been relocated already). returns the entity
+    // that was moved into the hole, or INVALID_ENTITY if none was.
+    auto removeRow(uint32_t chunk_index, uint32_t row, bool destroy) -> EntityID;
+    // destroys every row and hands the chunks back
+    void clear();
+
+    // whole-chunk copies for SnapshotRing, only for trivial archetypes
+    void save(SnapshotBuffer& out) const;
+    void load(SnapshotBuffer& in);
+
+    // cached archetype graph edges, filled lazily by the World
+    std::array<Archetype*, MAX_COMPONENTS> add_edges{};
+    std::array<Archetype*, MAX_COMPONENTS> remove_edges{};
+
+private:
+    static auto block(const Chunk& chunk, const Column& col) -> std::byte* { return col.cold ? chunk.cold : chunk.data; }
+    // empty chunk with its header ticks zeroed
+    auto newChunk() -> Chunk&;
+    auto allocateChunk() -> Chunk;
+    void releaseChunk(const Chunk& chunk);
+
+    Signature m_signature;
+    ChunkAllocator& m_allocator;
+    std::pmr::vector<Column> m_columns;
+    std::array<int8_t, MAX_COMPONENTS> m_column_index{};
+    bool m_trivial = true;
+    bool m_has_cold = false;
+    std::size_t m_entities_offset = 0;
+    uint32_t m_capacity = 0;
+    std::size_t m_size = 0;
+    std::pmr::vector<Chunk> m_chunks;
+};
+
+template <typename Fn>
+void Archetype::pushRows(const EntityID* entities, std::size_t count, Fn&& fill) {
+    while (count > 0) {
+        auto* chunk = m_chunks.empty() || m_chunks.back().count == m_capacity ? &newChunk() : &m_chunks.back();
+        auto first = chunk->count;
+        auto rows = static_cast<uint32_t>(std::min<std::size_t>(count, m_capacity - first));
+        std::copy_n(entities, rows, this->entities(*chunk) + first);
+        chunk->count += rows;
+        m_size += rows;
+        fill(static_cast<uint32_t>(m_chunks.size() - 1), first, rows);
+        entities += rows;
+        count -= rows;
+    }
+}
+
+} // namespace game
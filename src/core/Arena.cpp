@@ -0,0 +1,92 @@
+#include "core/Arena.hpp"
+
+#include <iterator>
+
+namespace game {
+
+namespace {
+
+// blocks are aligned for chunks, the most demanding user
+constexpr std::size_t BLOCK_ALIGN = 64;
+
+} // namespace
+
+Arena::Arena(std::size_t block_size, std::pmr::memory_resource* upstream)
+: m_block_size(block_size), m_upstream(upstream) {}
+
+void Arena::reset() {
+    m_spare.insert(m_spare.end(), m_large.begin(), m_large.end());
+    m_large.clear();
+    m_current = 0;
+    m_offset = 0;
+    m_used = 0;
+}
+
+void Arena::release() {
+    reset();
+    for (auto& block : m_spare)
+        m_upstream->deallocate(block.data, block.size, BLOCK_ALIGN);
+    m_spare.clear();
+    for (auto& block : m_blocks)
+        m_upstream->deallocate(block.data, block.size, BLOCK_ALIGN);
+    m_blocks.clear();
+    m_reserved = 0;
+}
+
+auto Arena::do_allocate(std::size_t bytes, std::size_t align) -> void* {
+    if (align > BLOCK_ALIGN)
+        throw std::bad_alloc();
+    m_used += bytes;
+
+    // big requests get their own block instead of wasting the rest of one
+    if (isLarge(bytes)) {
+        auto best = m_spare.end();
+        for (auto it = m_spare.begin(); it != m_spare.end(); ++it) {
+            if (it->size >= bytes && (best == m_spare.end() || it->size < best->size))
+                best = it;
+        }
+        if (best != m_spare.end()) {
+            m_large.push_back(*best);
+            m_spare.erase(best);
+            return m_large.back().data;
+        }
+        auto* data = static_cast<std::byte*>(m_upstream->allocate(bytes, BLOCK_ALIGN));
+        m_large.push_back({data, bytes});
+        m_reserved += bytes;
+        return data;
+    }
+
+    while (true) {
+        if (m_current < m_blocks.size()) {
+            auto offset = (m_offset + align - 1) & ~(align - 1);
+            if (offset + bytes <= m_blocks[m_current].size) {
+                m_offset = offset + bytes;
+                return m_blocks[m_current].data + offset;
+            }
+            // move on to the next kept block, the tail of this one is lost
+            ++m_current;
+            m_offset = 0;
+            continue;
+        }
+        auto* data = static_cast<std::byte*>(m_upstream->allocate(m_block_size, BLOCK_ALIGN));
+        m_blocks.push_back({data, m_block_size});
+        m_reserved += m_block_size;
+        m_current = m_blocks.size() - 1;
+        m_offset = 0;
+    }
+}
+
+void Arena::do_deallocate(void* ptr, std::size_t bytes, std::size_t) {
+    if (!isLarge(bytes))
+        return;
+    // the most recent large block is the likeliest, e.g. a vector growing
+    for (auto it = m_large.rbegin(); it != m_large.rend(); ++it) {
+        if (it->data == ptr) {
+            m_spare.push_back(*it);
+            m_large.erase(std::next(it).base());
+            return;
+        }
+    }
+}
+
+} // namespace game
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace game {
+
+// bump allocator owning all the memory of one room's World. deallocate is a
+// no-op for small allocations; reset() rewinds to the first block while
+// keeping every block for the next match, so tearing a room down doesn't
+// free anything and matchmaking churn doesn't go through the global
+// allocator. allocations bigger than a quarter block (e.g. a growing
+// entity record array) get a block of their own; deallocate and reset()
+// keep it as a spare for later big allocations that fit.
+// not thread-safe: it is only used for structural changes, which are
+// single-threaded (see CommandBuffer).
+class Arena final : public std::pmr::memory_resource {
+public:
+    explicit Arena(std::size_t block_size = DEFAULT_BLOCK_SIZE,
+                   std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+    Arena(const Arena&) = delete;
+    auto operator=(const Arena&) -> Arena& = delete;
+    ~Arena() override { release(); }
+
+    // forgets every allocation, keeps the blocks, frees nothing
+    void reset();
+    // gives every block back to the upstream resource
+    void release();
+
+    // bytes handed out since the last reset
+    auto used() const -> std::size_t { return m_used; }
+    // bytes held from upstream
+    auto reserved() const -> std::size_t { return m_reserved; }
+
+    static constexpr std::size_t DEFAULT_BLOCK_SIZE = 256 * 1024;
+
+    // constructs a T in the arena; it must be destroyed with destroy()
+    template <typename T, typename... Args>
+    auto create(Args&&... args) -> T* {
+        return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+    template <typename T>
+    void destroy(T* ptr) {
+        ptr->~T();
+    }
+
+private:
+    struct Block {
+        std::byte* data;
+        std::size_t size;
+    };
+
+    auto isLarge(std::size_t bytes) const -> bool { return bytes > m_block_size / 4; }
+
+    auto do_allocate(std::size_t bytes, std::size_t align) -> void* override;
+    void do_deallocate(void* ptr, std::size_t bytes, std::size_t align) override;
+    auto do_is_equal(const std::pmr::memory_resource& other) const noexcept -> bool override {
+        return this == &other;
+    }
+
+    std::size_t m_block_size;
+    std::pmr::memory_resource* m_upstream;
+    // blocks of m_block_size, reused after reset()
+    std::vector<Block> m_blocks;
+    // oversized allocations in use
+    std::vector<Block> m_large;
+    // oversized blocks no longer in use, reused best fit
+    std::vector<Block> m_spare;
+    std::size_t m_current = 0;
+    std::size_t m_offset = 0;
+    std::size_t m_used = 0;
+    std::size_t m_reserved = 0;
+};
+
+} // namespace game
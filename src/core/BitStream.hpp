@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+namespace game {
+
+// packs values of arbitrary bit width into a caller-provided buffer, least
+// significant bit first. throws std::length_error when the buffer is full.
+class BitWriter {
+public:
+    BitWriter(uint8_t* data, std::size_t capacity) : m_data(data), m_capacity(capacity) {}
+
+    void write(uint64_t value, unsigned bits) {
+        while (bits > 0) {
+            auto count = bits > 32 ? 32u : bits;
+            m_scratch |= (value & ((uint64_t{1} << count) - 1)) << m_scratch_bits;
+            m_scratch_bits += count;
+            value >>= count;
+            bits -= count;
+            while (m_scratch_bits >= 8) {
+                emit(static_cast<uint8_t>(m_scratch));
+                m_scratch >>= 8;
+                m_scratch_bits -= 8;
+            }
+        }
+    }
+    void writeBool(bool value) { write(value ? 1 : 0, 1); }
+
+    // writes out the last partial byte, returns the bytes used
+    auto flush() -> std::size_t {
+        if (m_scratch_bits > 0) {
+            emit(static_cast<uint8_t>(m_scratch));
+            m_scratch = 0;
+            m_scratch_bits = 0;
+        }
+        return m_size;
+    }
+    auto bitsWritten() const -> std::size_t { return m_size * 8 + m_scratch_bits; }
+
+private:
+    void emit(uint8_t byte) {
+        if (m_size == m_capacity)
+            throw std::length_error("bit stream buffer is full");
+        m_data[m_size++] = byte;
+    }
+
+    uint8_t* m_data;
+    std::size_t m_capacity;
+    std::size_t m_size = 0;
+    uint64_t m_scratch = 0;
+    unsigned m_scratch_bits = 0;
+};
+
+// reads what a BitWriter wrote. throws std::out_of_range past the end.
+class BitReader {
+public:
+    BitReader(const uint8_t* data, std::size_t size) : m_data(data), m_size(size) {}
+
+    auto read(unsigned bits) -> uint64_t {
+        uint64_t value = 0;
+        unsigned shift = 0;
+        while (bits > 0) {
+            auto count = bits > 32 ? 32u : bits;
+            while (m_scratch_bits < count) {
+                if (m_read == m_size)
+                    throw std::out_of_range("read past the end of the bit stream");
+                m_scratch |= uint64_t{m_data[m_read++]} << m_scratch_bits;
+                m_scratch_bits += 8;
+            }
+            value |= (m_scratch & ((uint64_t{1} << count) - 1)) << shift;
+            m_scratch >>= count;
+            m_scratch_bits -= count;
+            shift += count;
+            bits -= count;
+        }
+        return value;
+    }
+    auto readBool() -> bool { return read(1) != 0; }
+
+    auto bitsRead() const -> std::size_t { return m_read * 8 - m_scratch_bits; }
+
+private:
+    const uint8_t* m_data;
+    std::size_t m_size;
+    std::size_t m_read = 0;
+    uint64_t m_scratch = 0;
+    unsigned m_scratch_bits = 0;
+};
+
+} // namespace game
@@ -0,0 +1,32 @@
+#include "core/Chunk.hpp"
+
+namespace game {
+
+ChunkAllocator::ChunkAllocator(std::pmr::memory_resource* resource) : m_resource(resource) {}
+
+ChunkAllocator::~ChunkAllocator() {
+    for (auto* block : m_blocks)
+        m_resource->deallocate(block, CHUNK_SIZE, CHUNK_ALIGN);
+}
+
+auto ChunkAllocator::allocate() -> std::byte* {
+    if (!m_free.empty()) {
+        auto* block = m_free.back();
+        m_free.pop_back();
+        return block;
+    }
+    auto* block = static_cast<std::byte*>(m_resource->allocate(CHUNK_SIZE, CHUNK_ALIGN));
+    m_blocks.push_back(block);
+    return block;
+}
+
+void ChunkAllocator::release(std::byte* block) {
+    m_free.push_back(block);
+}
+
+void ChunkAllocator::reset() {
+    m_blocks.clear();
+    m_free.clear();
+}
+
+} // namespace game
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+namespace game {
+
+// archetype rows are stored in fixed size blocks, one column per component
+constexpr std::size_t CHUNK_SIZE = 16 * 1024;
+constexpr std::size_t CHUNK_ALIGN = 64;
+
+struct Chunk {
+    std::byte* data = nullptr;
+    // second block holding the cold columns, only for archetypes that have some
+    std::byte* cold = nullptr;
+    uint32_t count = 0;
+};
+
+// hands out CHUNK_SIZE blocks drawn from a memory resource (the World's
+// arena) and keeps released ones for reuse, so entities moving between
+// archetypes don't go back to the resource. blocks are only given back when
+// the allocator is destroyed, or all at once by reset().
+class ChunkAllocator {
+public:
+    explicit ChunkAllocator(std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+    ChunkAllocator(const ChunkAllocator&) = delete;
+    auto operator=(const ChunkAllocator&) -> ChunkAllocator& = delete;
+    ~ChunkAllocator();
+
+    auto allocate() -> std::byte*;
+    void release(std::byte* block);
+    // forgets every block without giving it back, for when the resource
+    // itself is about to be reset
+    void reset();
+
+    auto resource() const -> std::pmr::memory_resource* { return m_resource; }
+    auto allocatedCount() const -> std::size_t { return m_blocks.size(); }
+
+private:
+    std::pmr::memory_resource* m_resource;
+    std::vector<std::byte*> m_blocks;
+    std::vector<std::byte*> m_free;
+};
+
+} // namespace game
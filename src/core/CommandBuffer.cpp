@@ -0,0 +1,74 @@
+#include "core/CommandBuffer.hpp"
+
+namespace game {
+
+auto CommandBuffer::create() -> PendingEntity {
+    Command command{Op::Create, true, m_pending_count};
+    m_commands.push_back(command);
+    return {m_pending_count++};
+}
+
+void CommandBuffer::destroy(EntityID entity) {
+    m_commands.push_back({Op::Destroy, false, entity});
+}
+
+void CommandBuffer::playback(World& world) {
+    m_created.assign(m_pending_count, INVALID_ENTITY);
+    for (auto& command : m_commands) {
+        if (command.op == Op::Create) {
+            m_created[command.target] = world.createEntity();
+            continue;
+        }
+
+        auto entity = command.pending ? m_created[command.target] : command.target;
+        if (!world.isAlive(entity)) {
+            if (command.discard)
+                command.discard(command.payload);
+            continue;
+        }
+        if (command.op == Op::Destroy)
+            world.destroyEntity(entity);
+        else
+            command.apply(world, entity, command.payload);
+    }
+
+    m_commands.clear();
+    m_page_used = m_pages.empty() ? PAGE_SIZE : 0;
+    // keep the first page for the next frame
+    if (m_pages.size() > 1)
+        m_pages.resize(1);
+    m_pending_count = 0;
+}
+
+void CommandBuffer::clear() {
+    for (auto& command : m_commands) {
+        if (command.discard)
+            command.discard(command.payload);
+    }
+    m_commands.clear();
+    m_page_used = m_pages.empty() ? PAGE_SIZE : 0;
+    if (m_pages.size() > 1)
+        m_pages.resize(1);
+    m_pending_count = 0;
+    m_created.clear();
+}
+
+auto CommandBuffer::allocatePayload(std::size_t size, std::size_t align) -> void* {
+    auto offset = (m_page_used + align - 1) & ~(align - 1);
+    if (m_pages.empty() || offset + size > PAGE_SIZE) {
+        if (size > PAGE_SIZE) {
+            // oversized payloads get a page of their own, inserted before the
+            // current page so recording continues where it was
+            auto page = std::make_unique<std::byte[]>(size);
+            auto* data = page.get();
+            m_pages.insert(m_pages.end() - (m_pages.empty() ? 0 : 1), std::move(page));
+            return data;
+        }
+        m_pages.push_back(std::make_unique<std::byte[]>(PAGE_SIZE));
+        offset = 0;
+    }
+    m_page_used = offset + size;
+    return m_pages.back().get() + offset;
+}
+
+} // namespace game
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "core/World.hpp"
+
+namespace game {
+
+// entity created by a CommandBuffer, only known by its index in the buffer
+// until playback assigns it a real EntityID. the index means nothing to any
+// other buffer: a pending entity can only be given components through, and
+// resolved by, the buffer that created it.
+struct PendingEntity {
+    uint32_t index = 0;
+};
+
+// records structural changes (create/destroy/add/remove) while systems
+// iterate in parallel, and applies them to the World later at a sync point.
+// a buffer is not thread-safe: a parallel pass gives each of its tasks its
+// own buffer (see Query::parallelForEachChunk()), and a system's buffers are
+// played back in recording order, so the result doesn't depend on which
+// worker ran which task. commands targeting an entity that is no longer
+// alive at playback are skipped.
+class CommandBuffer {
+public:
+    CommandBuffer() = default;
+    CommandBuffer(const CommandBuffer&) = delete;
+    auto operator=(const CommandBuffer&) -> CommandBuffer& = delete;
+    CommandBuffer(CommandBuffer&&) = default;
+    auto operator=(CommandBuffer&&) -> CommandBuffer& = default;
+    ~CommandBuffer() { clear(); }
+
+    auto create() -> PendingEntity;
+    void destroy(EntityID entity);
+
+    template <typename T>
+    void add(EntityID entity, T component = {}) { record<T>(entity, false, std::move(component)); }
+    template <typename T>
+    void add(PendingEntity entity, T component = {}) { record<T>(entity.index, true, std::move(component)); }
+    template <typename T>
+    void remove(EntityID entity);
+
+    auto empty() const -> bool { return m_commands.empty(); }
+    auto size() const -> std::size_t { return m_commands.size(); }
+
+    // applies every command in recording order, then empties the buffer
+    void playback(World& world);
+    // EntityID assigned to a pending entity by the last playback
+    auto resolve(PendingEntity entity) const -> EntityID { return m_created.at(entity.index); }
+    // drops recorded commands without applying them
+    void clear();
+
+private:
+    enum class Op : uint8_t {
+        Create,
+        Destroy,
+        Add,
+        Remove,
+    };
+    struct Command {
+        Op op;
+        // target is a pending entity index instead of an EntityID
+        bool pending = false;
+        uint32_t target = 0;
+        void* payload = nullptr;
+        void (*apply)(World&, EntityID, void* payload) = nullptr;
+        void (*discard)(void* payload) = nullptr;
+    };
+
+    template <typename T>
+    void record(uint32_t target, bool pending, T&& component);
+    // payload memory that stays put while more commands are recorded
+    auto allocatePayload(std::size_t size, std::size_t align) -> void*;
+
+    static constexpr std::size_t PAGE_SIZE = 4096;
+
+    std::vector<Command> m_commands;
+    std::vector<std::unique_ptr<std::byte[]>> m_pages;
+    std::size_t m_page_used = PAGE_SIZE;
+    uint32_t m_pending_count = 0;
+    std::vector<EntityID> m_created;
+};
+
+template <typename T>
+void CommandBuffer::record(uint32_t target, bool pending, T&& component) {
+    using Component = std::decay_t<T>;
+    static_assert(alignof(Component) <= alignof(std::max_align_t), "over-aligned component");
+
+    auto* payload = new (allocatePayload(sizeof(Component), alignof(Component))) Component(std::move(component));
+    Command command{Op::Add, pending, target, payload};
+    command.apply = [](World& world, EntityID entity, void* data) {
+        auto* value = static_cast<Component*>(data);
+        world.add<Component>(entity, std::move(*value));
+        value->~Component();
+    };
+    command.discard = [](void* data) { static_cast<Component*>(data)->~Component(); };
+    m_commands.push_back(command);
+}
+
+template <typename T>
+void CommandBuffer::remove(EntityID entity) {
+    Command command{Op::Remove, false, entity};
+    command.apply = [](World& world, EntityID target, void*) { world.remove<T>(target); };
+    m_commands.push_back(command);
+}
+
+} // namespace game
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <bitset>
+#include <cstddef>
+#include <type_traits>
+
+#include "common/types.hpp"
+
+namespace game {
+
+// upper bound for ComponentTypeID values, one bit per component in a Signature
+constexpr std::size_t MAX_COMPONENTS = 64;
+
+// set of component types attached to an entity (or required by a query)
+using Signature = std::bitset<MAX_COMPONENTS>;
+
+// Archetype: stored in the entity's archetype chunk, best for data iterated every tick.
+// Cold: stored with the archetype too, but in a separate block per chunk so
+// it doesn't take room in the chunks per-tick loops stream through. for data
+// read rarely, e.g. once at spawn.
+// Sparse: stored in a sparse-set pool, best for components added and removed
+// often since that doesn't move the entity's other components between chunks.
+enum class StorageMode : uint8_t {
+    Archetype,
+    Cold,
+    Sparse,
+};
+
+// every component type specializes this next to its definition:
+//     template <> struct ComponentTraits<components::Position> {
+//         static constexpr ComponentTypeID id = ComponentType::Position;
+//         static constexpr const char* name = "Position";
+//         // optional, defaults to StorageMode::Archetype
+//         static constexpr StorageMode storage = StorageMode::Sparse;
+//     };
+template <typename T>
+struct ComponentTraits;
+
+template <typename T>
+constexpr auto componentId() -> ComponentTypeID {
+    static_assert(ComponentTraits<T>::id < MAX_COMPONENTS, "ComponentTypeID out of range");
+    return ComponentTraits<T>::id;
+}
+
+namespace detail {
+
+template <typename T, typename = void>
+struct storage_mode_ {
+    static constexpr StorageMode value = StorageMode::Archetype;
+};
+
+template <typename T>
+struct storage_mode_<T, std::void_t<decltype(ComponentTraits<T>::storage)>> {
+    static constexpr StorageMode value = ComponentTraits<T>::storage;
+};
+
+} // namespace detail
+
+template <typename T>
+constexpr StorageMode storageModeOf = detail::storage_mode_<T>::value;
+
+template <typename T>
+constexpr bool isSparse = storageModeOf<T> == StorageMode::Sparse;
+
+template <typename... Ts>
+auto signatureOf() -> Signature {
+    Signature signature;
+    (signature.set(componentId<Ts>()), ...);
+    return signature;
+}
+
+} // namespace game
@@ -0,0 +1,40 @@
+#include "core/ComponentRegistry.hpp"
+
+#include <stdexcept>
+#include <string>
+
+#include "core/components/Components.hpp"
+
+namespace game {
+
+auto ComponentRegistry::instance() -> ComponentRegistry& {
+    static ComponentRegistry instance;
+    return instance;
+}
+
+void ComponentRegistry::registerDefaults() {
+    static std::once_flag once;
+    std::call_once(once, [] {
+        registerComponent<components::Position>();
+        registerComponent<components::Velocity>();
+        registerComponent<components::Health>();
+        registerComponent<components::PlayerComponent>();
+        registerComponent<components::Transform>();
+        registerComponent<components::InputComponent>();
+        registerComponent<components::CollisionComponent>();
+    });
+}
+
+auto ComponentRegistry::isRegistered(ComponentTypeID id) -> bool {
+    if (id >= MAX_COMPONENTS)
+        return false;
+    return (instance().m_registered.load(std::memory_order_acquire) & (uint64_t{1} << id)) != 0;
+}
+
+auto ComponentRegistry::get(ComponentTypeID id) -> const ComponentInfo& {
+    if (!isRegistered(id))
+        throw std::out_of_range("component type " + std::to_string(id) + " is not registered");
+    return instance().m_infos[id];
+}
+
+} // namespace game
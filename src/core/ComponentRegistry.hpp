@@ -0,0 +1,80 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "core/Component.hpp"
+
+namespace game {
+
+// type-erased description of a component, used by the archetype storage to
+// lay out chunk columns and to move rows between archetypes
+struct ComponentInfo {
+    ComponentTypeID id = 0;
+    const char* name = "";
+    std::size_t size = 0;
+    std::size_t align = 0;
+    StorageMode storage = StorageMode::Archetype;
+    // trivially copyable components are relocated with memcpy and never destroyed
+    bool trivial = false;
+    void (*construct)(void* dst) = nullptr;
+    // move-constructs into dst and destroys src
+    void (*relocate)(void* dst, void* src) = nullptr;
+    void (*destroy)(void* ptr) = nullptr;
+};
+
+class ComponentRegistry {
+public:
+    ComponentRegistry(const ComponentRegistry&) = delete;
+
+    template <typename T>
+    static auto registerComponent() -> const ComponentInfo&;
+
+    // registers every component listed in ComponentType (types.hpp)
+    static void registerDefaults();
+
+    static auto isRegistered(ComponentTypeID id) -> bool;
+    static auto get(ComponentTypeID id) -> const ComponentInfo&;
+
+private:
+    ComponentRegistry() = default;
+    static auto instance() -> ComponentRegistry&;
+
+    std::array<ComponentInfo, MAX_COMPONENTS> m_infos{};
+    std::atomic<uint64_t> m_registered{0};
+    std::mutex m_mutex;
+};
+
+template <typename T>
+auto ComponentRegistry::registerComponent() -> const ComponentInfo& {
+    static_assert(std::is_default_constructible_v<T>, "components must be default constructible");
+    static_assert(std::is_nothrow_move_constructible_v<T>, "components must be nothrow movable");
+
+    constexpr auto id = componentId<T>();
+    auto& registry = instance();
+    if (registry.m_registered.load(std::memory_order_acquire) & (uint64_t{1} << id))
+        return registry.m_infos[id];
+
+    std::lock_guard<std::mutex> lock(registry.m_mutex);
+    auto& info = registry.m_infos[id];
+    info.id = id;
+    info.name = ComponentTraits<T>::name;
+    info.size = sizeof(T);
+    info.align = alignof(T);
+    info.storage = storageModeOf<T>;
+    info.trivial = std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>;
+    info.construct = [](void* dst) { new (dst) T(); };
+    info.relocate = [](void* dst, void* src) {
+        new (dst) T(std::move(*static_cast<T*>(src)));
+        static_cast<T*>(src)->~T();
+    };
+    info.destroy = [](void* ptr) { static_cast<T*>(ptr)->~T(); };
+    registry.m_registered.fetch_or(uint64_t{1} << id, std::memory_order_release);
+    return info;
+}
+
+} // namespace game
@@ -0,0 +1,109 @@
+#include "core/Entity.hpp"
+
+#include <stdexcept>
+
+namespace game {
+
+auto EntityAllocator::create() -> EntityID {
+    uint32_t index;
+    if (freeCount() > MIN_FREE || (freeCount() > 0 && m_slots.size() >= MAX_ENTITIES)) {
+        index = m_free[m_free_head++];
+        // compact once half the storage is reused entries, amortized O(1)
+        if (m_free_head * 2 >= m_free.size()) {
+            m_free.erase(m_free.begin(), m_free.begin() + static_cast<std::ptrdiff_t>(m_free_head));
+            m_free_head = 0;
+        }
+    }
+    else {
+        if (m_slots.size() >= MAX_ENTITIES)
+            throw std::length_error("entity limit reached");
+        index = static_cast<uint32_t>(m_slots.size());
+        m_slots.emplace_back();
+    }
+
+    auto& slot = m_slots[index];
+    slot.alive = true;
+    return makeEntity(index, slot.generation);
+}
+
+auto EntityAllocator::destroy(EntityID entity, SequenceNumber death) -> bool {
+    if (!isAlive(entity))
+        return false;
+
+    auto index = entityIndex(entity);
+    auto& slot = m_slots[index];
+    slot.alive = false;
+    if (slot.generation == ENTITY_GENERATION_MASK) {
+        ++m_retired;
+        return true;
+    }
+    ++slot.generation;
+    if (m_quarantine_enabled)
+        m_quarantine.push_back({index, death});
+    else
+        m_free.push_back(index);
+    return true;
+}
+
+void EntityAllocator::setQuarantine(bool enabled) {
+    m_quarantine_enabled = enabled;
+    if (enabled)
+        return;
+    for (auto i = m_quarantine_head; i < m_quarantine.size(); ++i)
+        m_free.push_back(m_quarantine[i].index);
+    m_quarantine.clear();
+    m_quarantine_head = 0;
+}
+
+void EntityAllocator::acknowledge(SequenceNumber oldest_ack) {
+    // deaths are pushed in tick order, so the releasable ones are a prefix
+    while (m_quarantine_head < m_quarantine.size() &&
+           sequenceGreaterThan(oldest_ack, m_quarantine[m_quarantine_head].death)) {
+        m_free.push_back(m_quarantine[m_quarantine_head].index);
+        ++m_quarantine_head;
+    }
+    // compact once half the storage is released entries, amortized O(1)
+    if (m_quarantine_head == m_quarantine.size()) {
+        m_quarantine.clear();
+        m_quarantine_head = 0;
+    }
+    else if (m_quarantine_head * 2 >= m_quarantine.size()) {
+        m_quarantine.erase(m_quarantine.begin(), m_quarantine.begin() + static_cast<std::ptrdiff_t>(m_quarantine_head));
+        m_quarantine_head = 0;
+    }
+}
+
+void EntityAllocator::save(SnapshotBuffer& out) const {
+    out.write(m_slots.size());
+    out.write(m_slots.data(), m_slots.size() * sizeof(Slot));
+    out.write(freeCount());
+    out.write(m_free.data() + m_free_head, freeCount() * sizeof(uint32_t));
+    out.write(m_retired);
+    out.write(quarantinedCount());
+    out.write(m_quarantine.data() + m_quarantine_head, quarantinedCount() * sizeof(Quarantined));
+}
+
+void EntityAllocator::load(SnapshotBuffer& in) {
+    m_slots.resize(in.read<std::size_t>());
+    in.read(m_slots.data(), m_slots.size() * sizeof(Slot));
+    m_free_head = 0;
+    m_free.resize(in.read<std::size_t>());
+    in.read(m_free.data(), m_free.size() * sizeof(uint32_t));
+    m_retired = in.read<std::size_t>();
+    m_quarantine_head = 0;
+    m_quarantine.resize(in.read<std::size_t>());
+    in.read(m_quarantine.data(), m_quarantine.size() * sizeof(Quarantined));
+}
+
+void EntityAllocator::clear() {
+    // drop the storage too, it may live in an arena about to be reset
+    auto* resource = m_slots.get_allocator().resource();
+    m_slots = std::pmr::vector<Slot>(resource);
+    m_free = std::pmr::vector<uint32_t>(resource);
+    m_quarantine = std::pmr::vector<Quarantined>(resource);
+    m_quarantine_head = 0;
+    m_free_head = 0;
+    m_retired = 0;
+}
+
+} // namespace game
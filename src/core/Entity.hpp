@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+#include "common/types.hpp"
+#include "core/Snapshot.hpp"
+
+namespace game {
+
+// an EntityID is a generational handle: the low bits index the entity slot,
+// the high bits count how many times that slot has been reused. a handle to a
+// destroyed entity keeps its old generation and fails validation, instead of
+// aliasing whichever entity recycled the slot.
+constexpr uint32_t ENTITY_INDEX_BITS = 20;
+constexpr uint32_t ENTITY_GENERATION_BITS = 32 - ENTITY_INDEX_BITS;
+constexpr uint32_t ENTITY_INDEX_MASK = (1u << ENTITY_INDEX_BITS) - 1;
+constexpr uint32_t ENTITY_GENERATION_MASK = (1u << ENTITY_GENERATION_BITS) - 1;
+// the all-ones index is never handed out so INVALID_ENTITY stays invalid
+constexpr uint32_t MAX_ENTITIES = ENTITY_INDEX_MASK;
+
+constexpr auto entityIndex(EntityID entity) -> uint32_t {
+    return entity & ENTITY_INDEX_MASK;
+}
+
+constexpr auto entityGeneration(EntityID entity) -> uint32_t {
+    return entity >> ENTITY_INDEX_BITS;
+}
+
+constexpr auto makeEntity(uint32_t index, uint32_t generation) -> EntityID {
+    return (generation & ENTITY_GENERATION_MASK) << ENTITY_INDEX_BITS | (index & ENTITY_INDEX_MASK);
+}
+
+static_assert(entityIndex(INVALID_ENTITY) == MAX_ENTITIES, "INVALID_ENTITY must use the reserved index");
+
+// hands out generational EntityIDs; create, destroy and isAlive are O(1)
+//
+// freed indices are reused oldest first, and only once MIN_FREE of them
+// are waiting, so a slot is reused at most every MIN_FREE creations: a
+// projectile spawned every tick takes hours, not seconds, to cycle one
+// slot's generations. a slot whose last generation dies is retired for
+// good instead of wrapping back to 0, so a stale handle held by a timer or
+// an event can never alias a live entity.
+//
+// with quarantine enabled a destroyed index isn't reused until every client
+// has acknowledged a snapshot taken after the death: clients then never see
+// the same index stand for two entities, and late packets about the dead one
+// can't land on its successor. ids stay dense, the cost is a few slots held
+// for about one round trip.
+class EntityAllocator {
+public:
+    explicit EntityAllocator(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+    : m_slots(resource), m_free(resource), m_quarantine(resource) {}
+
+    auto create() -> EntityID;
+    // returns false if the handle was stale. death is the snapshot sequence
+    // the entity is first missing from, only used under quarantine.
+    auto destroy(EntityID entity, SequenceNumber death = 0) -> bool;
+    auto isAlive(EntityID entity) const -> bool {
+        auto index = entityIndex(entity);
+        return index < m_slots.size() && m_slots[index].alive &&
+               m_slots[index].generation == entityGeneration(entity);
+    }
+
+    // off by default; turning it off releases every quarantined index
+    void setQuarantine(bool enabled);
+    auto quarantine() const -> bool { return m_quarantine_enabled; }
+    // releases the indices of entities that died before oldest_ack, the
+    // oldest sequence acknowledged by every client. O(1) per released index.
+    void acknowledge(SequenceNumber oldest_ack);
+    auto quarantinedCount() const -> std::size_t { return m_quarantine.size() - m_quarantine_head; }
+
+    auto freeCount() const -> std::size_t { return m_free.size() - m_free_head; }
+    auto retiredCount() const -> std::size_t { return m_retired; }
+    auto aliveCount() const -> std::size_t {
+        return m_slots.size() - freeCount() - quarantinedCount() - m_retired;
+    }
+    // number of slots ever used, i.e. one past the highest index
+    auto slotCount() const -> std::size_t { return m_slots.size(); }
+    void clear();
+
+    void save(SnapshotBuffer& out) const;
+    void load(SnapshotBuffer& in);
+
+    static constexpr std::size_t MIN_FREE = 1024;
+
+private:
+    struct Slot {
+        uint16_t generation = 0;
+        bool alive = false;
+    };
+    static_assert(ENTITY_GENERATION_BITS <= 16, "generation must fit in Slot::generation");
+
+    struct Quarantined {
+        uint32_t index;
+        SequenceNumber death;
+    };
+
+    std::pmr::vector<Slot> m_slots;
+    // FIFO; entries before m_free_head were reused
+    std::pmr::vector<uint32_t> m_free;
+    std::size_t m_free_head = 0;
+    // slots with no generation left
+    std::size_t m_retired = 0;
+    // FIFO in death order; entries before m_quarantine_head are released
+    std::pmr::vector<Quarantined> m_quarantine;
+    std::size_t m_quarantine_head = 0;
+    bool m_quarantine_enabled = false;
+};
+
+} // namespace game
@@ -0,0 +1,56 @@
+#include "core/Event.hpp"
+
+#include <cstring>
+
+namespace game {
+
+EventQueueBase::EventQueueBase(std::size_t event_size, std::size_t event_align, std::size_t capacity,
+                               std::pmr::memory_resource* resource)
+: m_event_size(event_size), m_event_align(event_align), m_resource(resource) {
+    grow(capacity > 0 ? capacity : 1);
+}
+
+EventQueueBase::~EventQueueBase() {
+    for (auto* buffer : m_buffers)
+        m_resource->deallocate(buffer, m_capacity * m_event_size, m_event_align);
+}
+
+void EventQueueBase::swap(Tick tick) {
+    auto sent = m_write_count.load(std::memory_order_relaxed);
+    m_read_count = sent < m_capacity ? sent : m_capacity;
+    m_dropped = sent - m_read_count;
+    m_read_tick = tick;
+    m_write ^= 1;
+    m_write_count.store(0, std::memory_order_relaxed);
+
+    if (m_dropped > 0) {
+        auto capacity = 2 * m_capacity;
+        grow(capacity > sent ? capacity : sent);
+    }
+}
+
+void EventQueueBase::reset() {
+    m_write_count.store(0, std::memory_order_relaxed);
+    m_read_count = 0;
+    m_read_tick = 0;
+    m_dropped = 0;
+}
+
+void EventQueueBase::grow(std::size_t capacity) {
+    std::byte* buffers[2];
+    for (auto& buffer : buffers)
+        buffer = static_cast<std::byte*>(m_resource->allocate(capacity * m_event_size, m_event_align));
+    // only the readable buffer has live events
+    auto read = m_write ^ 1;
+    if (m_read_count > 0)
+        std::memcpy(buffers[read], m_buffers[read], m_read_count * m_event_size);
+    for (auto* buffer : m_buffers) {
+        if (buffer)
+            m_resource->deallocate(buffer, m_capacity * m_event_size, m_event_align);
+    }
+    m_buffers[0] = buffers[0];
+    m_buffers[1] = buffers[1];
+    m_capacity = capacity;
+}
+
+} // namespace game
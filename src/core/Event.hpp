@@ -0,0 +1,122 @@
+#pragma once
+
+#include <atomic>
+#include <bitset>
+#include <cstddef>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+
+#include "common/types.hpp"
+#include "core/Span.hpp"
+
+namespace game {
+
+// upper bound for EventTypeID values
+constexpr std::size_t MAX_EVENT_TYPES = 32;
+
+// every event type specializes this next to its definition:
+//     template <> struct EventTraits<events::DamageEvent> {
+//         static constexpr EventTypeID id = EventType::Damage;
+//         static constexpr const char* name = "Damage";
+//     };
+template <typename E>
+struct EventTraits;
+
+template <typename E>
+constexpr auto eventId() -> EventTypeID {
+    static_assert(EventTraits<E>::id < MAX_EVENT_TYPES, "EventTypeID out of range");
+    return EventTraits<E>::id;
+}
+
+// set of event types, used in system access declarations
+using EventSet = std::bitset<MAX_EVENT_TYPES>;
+
+template <typename... Es>
+auto eventSetOf() -> EventSet {
+    EventSet set;
+    (set.set(eventId<Es>()), ...);
+    return set;
+}
+
+// untyped part of an EventQueue. events are trivially copyable values
+// stored in two preallocated buffers: the one being written this tick, and
+// the one holding last tick's events for systems to read in bulk.
+class EventQueueBase {
+public:
+    EventQueueBase(std::size_t event_size, std::size_t event_align, std::size_t capacity,
+                   std::pmr::memory_resource* resource);
+    EventQueueBase(const EventQueueBase&) = delete;
+    auto operator=(const EventQueueBase&) -> EventQueueBase& = delete;
+    virtual ~EventQueueBase();
+
+    // end of tick: this tick's events become readable and the older ones are
+    // dropped by resetting a count. if sends overflowed, the buffers grow so
+    // the next tick fits, the only time a queue allocates.
+    void swap(Tick tick);
+    // drops the events of both ticks, keeping the buffers
+    void reset();
+
+    auto capacity() const -> std::size_t { return m_capacity; }
+    // tick the readable events were sent on
+    auto readTick() const -> Tick { return m_read_tick; }
+    // events lost to overflow during that tick
+    auto dropped() const -> std::size_t { return m_dropped; }
+
+protected:
+    // slot for one event, nullptr when the write buffer is full. safe to
+    // call from several threads at once.
+    auto reserve() -> void* {
+        auto index = m_write_count.fetch_add(1, std::memory_order_relaxed);
+        return index < m_capacity ? m_buffers[m_write] + index * m_event_size : nullptr;
+    }
+    auto readData() const -> const std::byte* { return m_buffers[m_write ^ 1]; }
+    auto readCount() const -> std::size_t { return m_read_count; }
+
+private:
+    void grow(std::size_t capacity);
+
+    std::size_t m_event_size;
+    std::size_t m_event_align;
+    std::pmr::memory_resource* m_resource;
+    std::byte* m_buffers[2] = {};
+    std::size_t m_capacity = 0;
+    // index of the buffer being written
+    unsigned m_write = 0;
+    std::atomic<std::size_t> m_write_count{0};
+    std::size_t m_read_count = 0;
+    Tick m_read_tick = 0;
+    std::size_t m_dropped = 0;
+};
+
+// typed double-buffered event stream, owned by the World. systems send()
+// during a tick (from any thread) and read() what was sent during the
+// previous one. neither side allocates or goes through callbacks, and the
+// readable events are a plain array that snapshot and replay code can
+// consume in place.
+template <typename E>
+class EventQueue final : public EventQueueBase {
+    static_assert(std::is_trivially_copyable_v<E> && std::is_trivially_destructible_v<E>,
+                  "events must be trivially copyable");
+
+public:
+    explicit EventQueue(std::pmr::memory_resource* resource, std::size_t capacity = DEFAULT_CAPACITY)
+    : EventQueueBase(sizeof(E), alignof(E), capacity, resource) {}
+
+    // returns false if the event was dropped because the tick's buffer is full
+    auto send(const E& event) -> bool {
+        auto* slot = reserve();
+        if (!slot)
+            return false;
+        new (slot) E(event);
+        return true;
+    }
+
+    auto read() const -> Span<const E> {
+        return {reinterpret_cast<const E*>(readData()), readCount()};
+    }
+
+    static constexpr std::size_t DEFAULT_CAPACITY = 256;
+};
+
+} // namespace game
@@ -0,0 +1,133 @@
+#include "core/JobSystem.hpp"
+
+namespace game {
+
+namespace {
+
+// which pool (and which of its queues) the current thread works for
+thread_local const ThreadPool* t_pool = nullptr;
+thread_local unsigned t_queue = 0;
+
+} // namespace
+
+ThreadPool::ThreadPool(unsigned worker_count) {
+    m_queues.reserve(worker_count + 1);
+    for (unsigned i = 0; i <= worker_count; ++i)
+        m_queues.push_back(std::make_unique<Queue>());
+
+    m_threads.reserve(worker_count);
+    for (unsigned i = 1; i <= worker_count; ++i)
+        m_threads.emplace_back([this, i] { workerLoop(i); });
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_sleep_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    for (auto& thread : m_threads)
+        thread.join();
+}
+
+auto ThreadPool::defaultWorkerCount() -> unsigned {
+    auto cores = std::thread::hardware_concurrency();
+    // the thread driving the tick helps while it waits
+    return cores > 1 ? cores - 1 : 0;
+}
+
+void ThreadPool::run(TaskGroup& group, std::function<void()> task) {
+    group.m_pending.fetch_add(1, std::memory_order_relaxed);
+
+    unsigned index;
+    if (t_pool == this)
+        index = t_queue;
+    else if (m_threads.empty())
+        index = 0;
+    else
+        index = 1 + m_next_queue.fetch_add(1, std::memory_order_relaxed) % workerCount();
+
+    {
+        std::lock_guard<std::mutex> lock(m_queues[index]->mutex);
+        m_queues[index]->tasks.push_back({std::move(task), &group});
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_sleep_mutex);
+        m_queued.fetch_add(1, std::memory_order_relaxed);
+    }
+    m_wake.notify_one();
+}
+
+void ThreadPool::wait(TaskGroup& group) {
+    auto index = t_pool == this ? t_queue : 0u;
+    while (group.pending() > 0) {
+        if (!tryRunOne(index))
+            std::this_thread::yield();
+    }
+
+    std::lock_guard<std::mutex> lock(group.m_error_mutex);
+    if (group.m_error) {
+        auto error = group.m_error;
+        group.m_error = nullptr;
+        std::rethrow_exception(error);
+    }
+}
+
+void ThreadPool::workerLoop(unsigned index) {
+    t_pool = this;
+    t_queue = index;
+    while (true) {
+        if (tryRunOne(index))
+            continue;
+        std::unique_lock<std::mutex> lock(m_sleep_mutex);
+        m_wake.wait(lock, [this] { return m_stop || m_queued.load(std::memory_order_relaxed) > 0; });
+        if (m_stop)
+            return;
+    }
+}
+
+auto ThreadPool::tryRunOne(unsigned index) -> bool {
+    Task task;
+    bool found = false;
+    {
+        // newest task of our own queue first, it is the most likely to be cached
+        auto& own = *m_queues[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            found = true;
+        }
+    }
+    // otherwise steal the oldest task of another queue
+    auto count = static_cast<unsigned>(m_queues.size());
+    for (unsigned i = 1; !found && i < count; ++i) {
+        auto& victim = *m_queues[(index + i) % count];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            found = true;
+        }
+    }
+    if (!found)
+        return false;
+
+    m_queued.fetch_sub(1, std::memory_order_relaxed);
+    execute(task);
+    return true;
+}
+
+void ThreadPool::execute(Task& task) {
+    try {
+        task.fn();
+    }
+    catch (...) {
+        std::lock_guard<std::mutex> lock(task.group->m_error_mutex);
+        if (!task.group->m_error)
+            task.group->m_error = std::current_exception();
+    }
+    task.group->m_pending.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+} // namespace game
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace game {
+
+// counts the tasks of one batch, ThreadPool::wait() returns once all of them ran
+class TaskGroup {
+public:
+    auto pending() const -> int { return m_pending.load(std::memory_order_acquire); }
+
+private:
+    friend class ThreadPool;
+    std::atomic<int> m_pending{0};
+    std::mutex m_error_mutex;
+    std::exception_ptr m_error;
+};
+
+// work-stealing thread pool: every worker owns a task deque, pops its own
+// newest task first and steals the oldest task of another worker when idle.
+// threads that wait on a TaskGroup run queued tasks instead of blocking, so
+// tasks may submit and wait on nested groups, and a pool with zero workers
+// simply runs everything on the waiting thread.
+class ThreadPool {
+public:
+    explicit ThreadPool(unsigned worker_count = defaultWorkerCount());
+    ThreadPool(const ThreadPool&) = delete;
+    auto operator=(const ThreadPool&) -> ThreadPool& = delete;
+    ~ThreadPool();
+
+    static auto defaultWorkerCount() -> unsigned;
+    auto workerCount() const -> unsigned { return static_cast<unsigned>(m_threads.size()); }
+
+    void run(TaskGroup& group, std::function<void()> task);
+    // helps running tasks until the group is done, rethrows the first
+    // exception thrown by one of its tasks
+    void wait(TaskGroup& group);
+
+private:
+    struct Task {
+        std::function<void()> fn;
+        TaskGroup* group = nullptr;
+    };
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void workerLoop(unsigned index);
+    auto tryRunOne(unsigned index) -> bool;
+    void execute(Task& task);
+
+    // queue 0 is shared by threads that are not pool workers
+    std::vector<std::unique_ptr<Queue>> m_queues;
+    std::vector<std::thread> m_threads;
+    std::atomic<unsigned> m_next_queue{0};
+
+    std::mutex m_sleep_mutex;
+    std::condition_variable m_wake;
+    std::atomic<int> m_queued{0};
+    bool m_stop = false;
+};
+
+} // namespace game
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <array>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "core/ComponentRegistry.hpp"
+
+namespace game {
+
+// an entity template compiled once (e.g. from a level editor definition):
+// the archetype signature and one row of default component values.
+// World::instantiate() creates any number of entities from it with a single
+// archetype bulk insert, copying the defaults column by column.
+class Prefab {
+public:
+    explicit Prefab(std::string name = {}) : m_name(std::move(name)) { m_offsets.fill(NO_COMPONENT); }
+
+    // adds the component (or replaces its default value)
+    template <typename T>
+    auto set(const T& component) -> Prefab&;
+    template <typename T>
+    auto has() const -> bool { return m_signature.test(componentId<T>()); }
+
+    auto name() const -> const std::string& { return m_name; }
+    auto signature() const -> const Signature& { return m_signature; }
+    // default value of a component of the signature
+    auto defaults(ComponentTypeID id) const -> const std::byte* { return m_row.data() + m_offsets[id]; }
+
+private:
+    static constexpr std::size_t NO_COMPONENT = ~std::size_t{0};
+
+    std::string m_name;
+    Signature m_signature;
+    // defaults packed back to back, they are only ever memcpy'd out
+    std::vector<std::byte> m_row;
+    std::array<std::size_t, MAX_COMPONENTS> m_offsets;
+};
+
+template <typename T>
+auto Prefab::set(const T& component) -> Prefab& {
+    static_assert(std::is_trivially_copyable_v<T>, "prefab rows are copied with memcpy");
+    static_assert(!isSparse<T>, "prefabs only hold archetype-stored components");
+    constexpr auto id = componentId<T>();
+    ComponentRegistry::registerComponent<T>();
+
+    if (m_offsets[id] == NO_COMPONENT) {
+        m_offsets[id] = m_row.size();
+        m_row.resize(m_row.size() + sizeof(T));
+        m_signature.set(id);
+    }
+    std::memcpy(m_row.data() + m_offsets[id], &component, sizeof(T));
+    return *this;
+}
+
+} // namespace game
@@ -0,0 +1,163 @@
+#include "core/Profiler.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+
+namespace game {
+
+namespace {
+
+auto highestBit(uint64_t value) -> unsigned {
+    unsigned bit = 0;
+    while (value >>= 1)
+        ++bit;
+    return bit;
+}
+
+} // namespace
+
+LatencyHistogram::LatencyHistogram() {
+    reset();
+}
+
+void LatencyHistogram::record(Microseconds duration) {
+    auto value = static_cast<uint64_t>(std::max<Microseconds::rep>(duration.count(), 0));
+    m_buckets[bucketOf(value)].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_total.fetch_add(value, std::memory_order_relaxed);
+    auto max = m_max.load(std::memory_order_relaxed);
+    while (value > max && !m_max.compare_exchange_weak(max, value, std::memory_order_relaxed)) {
+    }
+}
+
+void LatencyHistogram::reset() {
+    for (auto& bucket : m_buckets)
+        bucket.store(0, std::memory_order_relaxed);
+    m_count.store(0, std::memory_order_relaxed);
+    m_total.store(0, std::memory_order_relaxed);
+    m_max.store(0, std::memory_order_relaxed);
+}
+
+auto LatencyHistogram::mean() const -> Microseconds {
+    auto count = this->count();
+    return Microseconds(count ? m_total.load(std::memory_order_relaxed) / count : 0);
+}
+
+auto LatencyHistogram::percentile(double p) const -> Microseconds {
+    auto count = this->count();
+    if (count == 0)
+        return Microseconds(0);
+    auto target = static_cast<uint64_t>(std::ceil(std::clamp(p, 0.0, 100.0) / 100.0 * double(count)));
+    target = std::max<uint64_t>(target, 1);
+
+    uint64_t seen = 0;
+    for (std::size_t bucket = 0; bucket < BUCKETS; ++bucket) {
+        seen += m_buckets[bucket].load(std::memory_order_relaxed);
+        if (seen >= target)
+            return Microseconds(std::min(bucketUpperBound(bucket), m_max.load(std::memory_order_relaxed)));
+    }
+    return max();
+}
+
+auto LatencyHistogram::bucketOf(uint64_t value) -> std::size_t {
+    if (value < SUB_BUCKETS)
+        return value;
+    value = std::min(value, (uint64_t{1} << MAX_BITS) - 1);
+    auto shift = highestBit(value) - SUB_BUCKET_BITS;
+    // the SUB_BUCKET_BITS bits below the leading one pick the linear bucket
+    return SUB_BUCKETS * (shift + 1) + ((value >> shift) - SUB_BUCKETS);
+}
+
+auto LatencyHistogram::bucketUpperBound(std::size_t bucket) -> uint64_t {
+    if (bucket < 2 * SUB_BUCKETS)
+        return bucket;
+    auto shift = bucket / SUB_BUCKETS - 1;
+    auto lower = (SUB_BUCKETS + bucket % SUB_BUCKETS) << shift;
+    return lower + (uint64_t{1} << shift) - 1;
+}
+
+TickProfiler::TickProfiler(std::size_t ring_size) : m_ring_size(ring_size > 0 ? ring_size : 1) {
+    resizeRing();
+}
+
+void TickProfiler::addSystem(const char* name) {
+    m_names.push_back(name);
+    m_histograms.push_back(std::make_unique<LatencyHistogram>());
+    resizeRing();
+}
+
+void TickProfiler::beginTick(Tick tick) {
+    auto slot = m_recorded.load(std::memory_order_relaxed) % m_ring_size;
+    m_ticks[slot].tick.store(tick, std::memory_order_relaxed);
+    m_ticks[slot].total_us.store(0, std::memory_order_relaxed);
+    for (std::size_t system = 0; system < m_names.size(); ++system)
+        slotDuration(slot, system).store(0, std::memory_order_relaxed);
+}
+
+void TickProfiler::recordSystem(std::size_t system, Microseconds duration) {
+    m_histograms[system]->record(duration);
+    auto slot = m_recorded.load(std::memory_order_relaxed) % m_ring_size;
+    auto us = std::clamp<Microseconds::rep>(duration.count(), 0, UINT32_MAX);
+    slotDuration(slot, system).store(static_cast<uint32_t>(us), std::memory_order_relaxed);
+}
+
+void TickProfiler::endTick(Microseconds total) {
+    m_tick_histogram.record(total);
+    auto slot = m_recorded.load(std::memory_order_relaxed) % m_ring_size;
+    auto us = std::clamp<Microseconds::rep>(total.count(), 0, UINT32_MAX);
+    m_ticks[slot].total_us.store(static_cast<uint32_t>(us), std::memory_order_relaxed);
+    m_recorded.fetch_add(1, std::memory_order_release);
+}
+
+void TickProfiler::dump(std::ostream& out, Microseconds budget) const {
+    auto row = [&out](const char* name, const LatencyHistogram& histogram) {
+        out << std::left << std::setw(20) << name << std::right << std::setw(10) << histogram.count();
+        for (double p : {50.0, 90.0, 99.0, 99.9})
+            out << std::setw(9) << histogram.percentile(p).count();
+        out << std::setw(9) << histogram.max().count() << "\n";
+    };
+    out << std::left << std::setw(20) << "system" << std::right << std::setw(10) << "calls" << std::setw(9)
+        << "p50" << std::setw(9) << "p90" << std::setw(9) << "p99" << std::setw(9) << "p99.9" << std::setw(9)
+        << "max" << "  (us)\n";
+    for (std::size_t system = 0; system < m_names.size(); ++system)
+        row(m_names[system], *m_histograms[system]);
+    row("(tick)", m_tick_histogram);
+
+    auto recorded = m_recorded.load(std::memory_order_acquire);
+    auto kept = std::min<uint64_t>(recorded, m_ring_size);
+    out << "last " << kept << " ticks, budget " << budget.count() << " us:\n";
+    for (auto i = recorded - kept; i < recorded; ++i) {
+        auto slot = i % m_ring_size;
+        auto total = m_ticks[slot].total_us.load(std::memory_order_relaxed);
+        out << "tick " << m_ticks[slot].tick.load(std::memory_order_relaxed) << ": " << total << " us";
+
+        std::size_t slowest = 0;
+        for (std::size_t system = 0; system < m_names.size(); ++system) {
+            auto duration = slotDuration(slot, system).load(std::memory_order_relaxed);
+            out << (system == 0 ? " [" : ", ") << m_names[system] << " " << duration;
+            if (duration > slotDuration(slot, slowest).load(std::memory_order_relaxed))
+                slowest = system;
+        }
+        if (!m_names.empty())
+            out << "]";
+        if (total > static_cast<uint64_t>(budget.count()))
+            out << "  OVER BUDGET" << (m_names.empty() ? "" : ", slowest: ") << (m_names.empty() ? "" : m_names[slowest]);
+        out << "\n";
+    }
+}
+
+void TickProfiler::reset() {
+    for (auto& histogram : m_histograms)
+        histogram->reset();
+    m_tick_histogram.reset();
+    m_recorded.store(0, std::memory_order_relaxed);
+}
+
+void TickProfiler::resizeRing() {
+    m_ticks = std::make_unique<TickEntry[]>(m_ring_size);
+    m_durations = std::make_unique<std::atomic<uint32_t>[]>(m_ring_size * std::max<std::size_t>(m_names.size(), 1));
+    m_recorded.store(0, std::memory_order_relaxed);
+}
+
+} // namespace game
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <vector>
+
+#include "common/types.hpp"
+
+namespace game {
+
+// HDR-style latency histogram: exact below 32 us, then 32 linear buckets per
+// power of two, so any percentile is within ~3% of the recorded value.
+// record() is lock-free and may be called from several threads.
+class LatencyHistogram {
+public:
+    LatencyHistogram();
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    auto operator=(const LatencyHistogram&) -> LatencyHistogram& = delete;
+
+    void record(Microseconds duration);
+    void reset();
+
+    auto count() const -> uint64_t { return m_count.load(std::memory_order_relaxed); }
+    auto max() const -> Microseconds { return Microseconds(m_max.load(std::memory_order_relaxed)); }
+    auto mean() const -> Microseconds;
+    // upper bound of the bucket holding the p-th percentile, p in [0, 100]
+    auto percentile(double p) const -> Microseconds;
+
+private:
+    static constexpr unsigned SUB_BUCKET_BITS = 5;
+    static constexpr unsigned SUB_BUCKETS = 1u << SUB_BUCKET_BITS;
+    // values are clamped below 2^MAX_BITS us (about 19 hours)
+    static constexpr unsigned MAX_BITS = 36;
+    static constexpr std::size_t BUCKETS = SUB_BUCKETS * (MAX_BITS - SUB_BUCKET_BITS + 1);
+
+    static auto bucketOf(uint64_t value) -> std::size_t;
+    static auto bucketUpperBound(std::size_t bucket) -> uint64_t;
+
+    std::array<std::atomic<uint64_t>, BUCKETS> m_buckets;
+    std::atomic<uint64_t> m_count{0};
+    std::atomic<uint64_t> m_total{0};
+    std::atomic<uint64_t> m_max{0};
+};
+
+// per-system tick times of one room: a histogram per system, and the
+// per-system breakdown of the last N ticks, so a spike tick can be traced
+// back to the system that blew the budget. fed by the SystemManager.
+class TickProfiler {
+public:
+    explicit TickProfiler(std::size_t ring_size = DEFAULT_RING_SIZE);
+
+    // registers the next system index; resets the tick ring
+    void addSystem(const char* name);
+    auto systemCount() const -> std::size_t { return m_names.size(); }
+
+    void beginTick(Tick tick);
+    // thread-safe, each system records its own index
+    void recordSystem(std::size_t system, Microseconds duration);
+    void endTick(Microseconds total);
+
+    auto histogram(std::size_t system) const -> const LatencyHistogram& { return *m_histograms[system]; }
+    auto tickHistogram() const -> const LatencyHistogram& { return m_tick_histogram; }
+
+    // percentiles per system, then every tick still in the ring, marking the
+    // ones over budget with their slowest system. meant to be called between
+    // ticks; a dump racing a tick may show that tick partially.
+    void dump(std::ostream& out, Microseconds budget = TICK_BUDGET) const;
+    void reset();
+
+    // ticks of history, about two seconds at the default tick rate
+    static constexpr std::size_t DEFAULT_RING_SIZE = 2 * DEFAULT_TICK_RATE;
+    static constexpr Microseconds TICK_BUDGET{1'000'000 / DEFAULT_TICK_RATE};
+
+private:
+    struct TickEntry {
+        std::atomic<Tick> tick{0};
+        std::atomic<uint32_t> total_us{0};
+    };
+
+    void resizeRing();
+    auto slotDuration(std::size_t slot, std::size_t system) const -> std::atomic<uint32_t>& {
+        return m_durations[slot * m_names.size() + system];
+    }
+
+    std::vector<const char*> m_names;
+    std::vector<std::unique_ptr<LatencyHistogram>> m_histograms;
+    LatencyHistogram m_tick_histogram;
+
+    std::size_t m_ring_size;
+    std::unique_ptr<TickEntry[]> m_ticks;
+    // m_ring_size rows of one duration per system, in microseconds
+    std::unique_ptr<std::atomic<uint32_t>[]> m_durations;
+    // ticks recorded since the last reset, the current slot is m_recorded % m_ring_size
+    std::atomic<uint64_t> m_recorded{0};
+};
+
+} // namespace game
@@ -0,0 +1,315 @@
+#pragma once
+
+#include <memory_resource>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include "core/Archetype.hpp"
+#include "core/JobSystem.hpp"
+#include "core/Span.hpp"
+
+namespace game {
+
+class CommandBuffer;
+
+// one chunk of a query result: every column is a contiguous array of count() rows.
+// write() records the access on the World tick the view was created with.
+class ChunkView {
+public:
+    ChunkView(Archetype& archetype, Chunk& chunk, Tick tick)
+    : m_archetype(&archetype), m_chunk(&chunk), m_tick(tick) {}
+
+    auto count() const -> uint32_t { return m_chunk->count; }
+    auto archetype() const -> Archetype& { return *m_archetype; }
+    auto chunk() const -> Chunk& { return *m_chunk; }
+
+    auto entities() const -> Span<const EntityID> {
+        return {m_archetype->entities(*m_chunk), m_chunk->count};
+    }
+    template <typename T>
+    auto read() const -> Span<const T> {
+        return {m_archetype->columnData<T>(*m_chunk), m_chunk->count};
+    }
+    // whole column write, stamps the column in O(1)
+    template <typename T>
+    auto write() const -> Span<T> {
+        m_archetype->stampAll(*m_chunk, componentId<T>(), m_tick);
+        return {m_archetype->columnData<T>(*m_chunk), m_chunk->count};
+    }
+    // single row write, for passes that only touch a few rows of the chunk
+    template <typename T>
+    auto write(uint32_t row) const -> T& {
+        m_archetype->stamp(*m_chunk, componentId<T>(), row, m_tick);
+        return m_archetype->columnData<T>(*m_chunk)[row];
+    }
+
+    // true if any row of the column was written after tick `since`
+    template <typename T>
+    auto changedSince(Tick since) const -> bool {
+        return m_archetype->chunkTick(*m_chunk, componentId<T>()) > since;
+    }
+    template <typename T>
+    auto rowChangedSince(uint32_t row, Tick since) const -> bool {
+        return m_archetype->rowTick(*m_chunk, componentId<T>(), row) > since;
+    }
+    // for components the query doesn't require
+    template <typename T>
+    auto has() const -> bool { return m_archetype->hasColumn(componentId<T>()); }
+
+private:
+    Archetype* m_archetype;
+    Chunk* m_chunk;
+    Tick m_tick;
+};
+
+// persistent "all of `all`, none of `none`" query, owned by the World.
+// matching is done per archetype: the World offers every newly created
+// archetype to its queries, so entities changing signature never trigger a
+// rescan, they just move between archetypes that are already matched (or not).
+class Query {
+public:
+    Query(const Signature& all, const Signature& none, const Tick& world_tick,
+          std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+    : m_all(all), m_none(none), m_tick(&world_tick), m_archetypes(resource) {}
+
+    auto all() const -> const Signature& { return m_all; }
+    auto none() const -> const Signature& { return m_none; }
+    auto matches(const Signature& signature) const -> bool {
+        return (signature & m_all) == m_all && (signature & m_none).none();
+    }
+
+    auto archetypes() const -> const std::pmr::vector<Archetype*>& { return m_archetypes; }
+    // number of matching entities
+    auto size() const -> std::size_t;
+
+    // fn(ChunkView) for every non-empty matching chunk
+    template <typename F>
+    void forEachChunk(F&& fn) const;
+
+    // same, skipping chunks where T wasn't written after tick `since`. rows
+    // inside a visited chunk can be filtered further with ChunkView::rowChangedSince().
+    template <typename T, typename F>
+    void forEachChangedChunk(Tick since, F&& fn) const;
+
+    // fn(Ts&...) for every matching entity; Ts must be part of all() (throws
+    // std::invalid_argument otherwise), and non-const Ts are stamped as written
+    template <typename... Ts, typename F>
+    void each(F&& fn) const;
+
+    // forEachChunk split across the pool: consecutive chunks are grouped into
+    // tasks of at least min_grain entities. runs inline without a pool or when
+    // there are too few entities to give two tasks. fn runs concurrently, so it
+    // must only touch its own chunk.
+    template <typename F>
+    void parallelForEachChunk(ThreadPool* pool, std::size_t min_grain, F&& fn) const;
+    template <typename... Ts, typename F>
+    void parallelEach(ThreadPool* pool, std::size_t min_grain, F&& fn) const;
+    // number of tasks the passes above cut for this pool and grain, 1 when
+    // they run inline
+    auto taskCount(ThreadPool* pool, std::size_t min_grain) const -> std::size_t;
+    // same, handing fn a buffer to record structural changes into: task i
+    // records into commands[i], and tasks follow chunk order, so playing the
+    // buffers back in order gives the same World whichever worker ran which
+    // task. commands needs taskCount() buffers (throws std::invalid_argument
+    // otherwise), see System::parallelForEachChunk(). fn(ChunkView, CommandBuffer&)
+    // and fn(CommandBuffer&, EntityID, Ts&...) respectively.
+    template <typename F>
+    void parallelForEachChunk(ThreadPool* pool, std::size_t min_grain, Span<CommandBuffer> commands, F&& fn) const;
+    template <typename... Ts, typename F>
+    void parallelEach(ThreadPool* pool, std::size_t min_grain, Span<CommandBuffer> commands, F&& fn) const;
+
+    // called by the World when an archetype is created
+    void offer(Archetype* archetype) {
+        if (matches(archetype->signature()))
+            m_archetypes.push_back(archetype);
+    }
+    // called by the World when it is cleared: forgets every archetype and
+    // drops the cache storage, which lives in the World arena
+    void reset() { m_archetypes = std::pmr::vector<Archetype*>(m_archetypes.get_allocator().resource()); }
+
+private:
+    // position of a chunk in the query, archetype then chunk index
+    struct ChunkCursor {
+        std::size_t archetype;
+        std::size_t chunk;
+    };
+
+    auto runsInline(ThreadPool* pool, std::size_t min_grain) const -> bool {
+        return !pool || pool->workerCount() == 0 || size() < 2 * min_grain;
+    }
+    // cut(begin, end) for every task of a parallel pass, in chunk order.
+    // tasks are cut while walking the chunks, nothing is collected up front
+    template <typename F>
+    void forEachTask(std::size_t min_grain, F&& cut) const;
+    // fn(ChunkView) for the chunks from begin up to, not including, end
+    template <typename F>
+    void forEachChunkIn(ChunkCursor begin, ChunkCursor end, F& fn) const;
+    // each() and parallelEach() index the Ts columns of every chunk unchecked
+    template <typename... Ts>
+    void requireAll() const;
+
+    Signature m_all;
+    Signature m_none;
+    const Tick* m_tick;
+    std::pmr::vector<Archetype*> m_archetypes;
+};
+
+inline auto Query::size() const -> std::size_t {
+    std::size_t size = 0;
+    for (auto* archetype : m_archetypes)
+        size += archetype->size();
+    return size;
+}
+
+template <typename F>
+void Query::forEachChunk(F&& fn) const {
+    for (auto* archetype : m_archetypes) {
+        for (auto& chunk : archetype->chunks())
+            fn(ChunkView(*archetype, chunk, *m_tick));
+    }
+}
+
+template <typename T, typename F>
+void Query::forEachChangedChunk(Tick since, F&& fn) const {
+    constexpr auto id = componentId<T>();
+    for (auto* archetype : m_archetypes) {
+        for (auto& chunk : archetype->chunks()) {
+            if (archetype->chunkTick(chunk, id) > since)
+                fn(ChunkView(*archetype, chunk, *m_tick));
+        }
+    }
+}
+
+namespace detail {
+
+template <typename T>
+auto columnPointer(const ChunkView& view) -> T* {
+    if constexpr (std::is_const_v<T>)
+        return view.read<std::remove_const_t<T>>().data();
+    else
+        return view.write<T>().data();
+}
+
+} // namespace detail
+
+template <typename... Ts>
+void Query::requireAll() const {
+    auto check = [this](ComponentTypeID id, const char* name) {
+        if (!m_all.test(id))
+            throw std::invalid_argument(std::string("query doesn't require component ") + name);
+    };
+    (check(componentId<std::remove_const_t<Ts>>(), ComponentTraits<std::remove_const_t<Ts>>::name), ...);
+}
+
+template <typename... Ts, typename F>
+void Query::each(F&& fn) const {
+    requireAll<Ts...>();
+    forEachChunk([&](ChunkView view) {
+        auto count = view.count();
+        auto columns = std::make_tuple(detail::columnPointer<Ts>(view)...);
+        for (uint32_t i = 0; i < count; ++i)
+            fn(std::get<Ts*>(columns)[i]...);
+    });
+}
+
+template <typename F>
+void Query::forEachTask(std::size_t min_grain, F&& cut) const {
+    ChunkCursor begin{0, 0};
+    std::size_t rows = 0;
+    for (std::size_t a = 0; a < m_archetypes.size(); ++a) {
+        const auto& chunks = m_archetypes[a]->chunks();
+        for (std::size_t c = 0; c < chunks.size(); ++c) {
+            rows += chunks[c].count;
+            if (rows >= min_grain) {
+                ChunkCursor end{a, c + 1};
+                cut(begin, end);
+                begin = end;
+                rows = 0;
+            }
+        }
+    }
+    if (rows > 0)
+        cut(begin, ChunkCursor{m_archetypes.size(), 0});
+}
+
+inline auto Query::taskCount(ThreadPool* pool, std::size_t min_grain) const -> std::size_t {
+    if (runsInline(pool, min_grain))
+        return 1;
+    std::size_t count = 0;
+    forEachTask(min_grain, [&count](ChunkCursor, ChunkCursor) { ++count; });
+    return count;
+}
+
+template <typename F>
+void Query::parallelForEachChunk(ThreadPool* pool, std::size_t min_grain, F&& fn) const {
+    if (runsInline(pool, min_grain)) {
+        forEachChunk(fn);
+        return;
+    }
+    TaskGroup group;
+    forEachTask(min_grain, [&](ChunkCursor begin, ChunkCursor end) {
+        pool->run(group, [this, &fn, begin, end] { forEachChunkIn(begin, end, fn); });
+    });
+    pool->wait(group);
+}
+
+template <typename F>
+void Query::forEachChunkIn(ChunkCursor begin, ChunkCursor end, F& fn) const {
+    for (auto a = begin.archetype; a <= end.archetype && a < m_archetypes.size(); ++a) {
+        auto* archetype = m_archetypes[a];
+        auto& chunks = archetype->chunks();
+        auto first = a == begin.archetype ? begin.chunk : 0;
+        auto last = a == end.archetype ? end.chunk : chunks.size();
+        for (auto c = first; c < last; ++c)
+            fn(ChunkView(*archetype, chunks[c], *m_tick));
+    }
+}
+
+template <typename... Ts, typename F>
+void Query::parallelEach(ThreadPool* pool, std::size_t min_grain, F&& fn) const {
+    requireAll<Ts...>();
+    parallelForEachChunk(pool, min_grain, [&fn](ChunkView view) {
+        auto count = view.count();
+        auto columns = std::make_tuple(detail::columnPointer<Ts>(view)...);
+        for (uint32_t i = 0; i < count; ++i)
+            fn(std::get<Ts*>(columns)[i]...);
+    });
+}
+
+template <typename F>
+void Query::parallelForEachChunk(ThreadPool* pool, std::size_t min_grain, Span<CommandBuffer> commands,
+                                 F&& fn) const {
+    if (commands.size() < taskCount(pool, min_grain))
+        throw std::invalid_argument("parallel pass needs a command buffer per task");
+    if (runsInline(pool, min_grain)) {
+        forEachChunk([&](ChunkView view) { fn(view, commands[0]); });
+        return;
+    }
+    TaskGroup group;
+    std::size_t task = 0;
+    forEachTask(min_grain, [&](ChunkCursor begin, ChunkCursor end) {
+        auto* buffer = &commands[task++];
+        pool->run(group, [this, &fn, buffer, begin, end] {
+            auto record = [&fn, buffer](ChunkView view) { fn(view, *buffer); };
+            forEachChunkIn(begin, end, record);
+        });
+    });
+    pool->wait(group);
+}
+
+template <typename... Ts, typename F>
+void Query::parallelEach(ThreadPool* pool, std::size_t min_grain, Span<CommandBuffer> commands, F&& fn) const {
+    requireAll<Ts...>();
+    parallelForEachChunk(pool, min_grain, commands, [&fn](ChunkView view, CommandBuffer& buffer) {
+        auto count = view.count();
+        auto entities = view.entities();
+        auto columns = std::make_tuple(detail::columnPointer<Ts>(view)...);
+        for (uint32_t i = 0; i < count; ++i)
+            fn(buffer, entities[i], std::get<Ts*>(columns)[i]...);
+    });
+}
+
+} // namespace game
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <bitset>
+#include <cstddef>
+
+#include "common/types.hpp"
+
+namespace game {
+
+// upper bound for ResourceTypeID values
+constexpr std::size_t MAX_RESOURCES = 32;
+
+// set of resource types, used in system access declarations
+using ResourceSet = std::bitset<MAX_RESOURCES>;
+
+// every resource type specializes this next to its definition:
+//     template <> struct ResourceTraits<resources::LevelBounds> {
+//         static constexpr ResourceTypeID id = ResourceType::LevelBounds;
+//         static constexpr const char* name = "LevelBounds";
+//     };
+template <typename R>
+struct ResourceTraits;
+
+template <typename R>
+constexpr auto resourceId() -> ResourceTypeID {
+    static_assert(ResourceTraits<R>::id < MAX_RESOURCES, "ResourceTypeID out of range");
+    return ResourceTraits<R>::id;
+}
+
+template <typename... Rs>
+auto resourceSetOf() -> ResourceSet {
+    ResourceSet set;
+    (set.set(resourceId<Rs>()), ...);
+    return set;
+}
+
+} // namespace game
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "core/Component.hpp"
+
+namespace game {
+
+// one serialized field of a component, declared in its ComponentTraits:
+//     static constexpr auto fields = std::make_tuple(
+//         field("x", &Position::x, 24, -8192.0, 8192.0),
+//         field("y", &Position::y, 24, -8192.0, 8192.0));
+// floats are quantized to `bits` over [min, max], or sent raw when no range
+// is given. integers and bools are clamped to [min, min + 2^bits - 1] and
+// sent as an offset from min.
+template <typename C, typename M>
+struct FieldDesc {
+    using Class = C;
+    using Member = M;
+
+    const char* name;
+    M C::*member;
+    uint8_t bits;
+    double min;
+    double max;
+
+    constexpr auto raw() const -> bool { return std::is_floating_point_v<M> && min == max; }
+    // largest encoded value
+    constexpr auto maxCode() const -> uint64_t { return bits >= 64 ? ~uint64_t{0} : (uint64_t{1} << bits) - 1; }
+};
+
+template <typename C, typename M>
+constexpr auto field(const char* name, M C::*member, uint8_t bits = sizeof(M) * 8, double min = 0.0,
+                     double max = 0.0) -> FieldDesc<C, M> {
+    return {name, member, bits, min, max};
+}
+
+namespace detail {
+
+template <typename T, typename = void>
+struct has_fields_ : std::false_type {};
+
+template <typename T>
+struct has_fields_<T, std::void_t<decltype(ComponentTraits<T>::fields)>> : std::true_type {};
+
+constexpr uint64_t FNV_OFFSET = 14695981039346656037ull;
+constexpr uint64_t FNV_PRIME = 1099511628211ull;
+
+constexpr auto hashBytes(uint64_t hash, uint64_t value, int bytes) -> uint64_t {
+    for (int i = 0; i < bytes; ++i) {
+        hash ^= (value >> (8 * i)) & 0xff;
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+constexpr auto hashString(uint64_t hash, const char* str) -> uint64_t {
+    for (; *str; ++str) {
+        hash ^= static_cast<unsigned char>(*str);
+        hash *= FNV_PRIME;
+    }
+    // terminator, so "ab" + "c" differs from "a" + "bc"
+    return hashBytes(hash, 0, 1);
+}
+
+template <typename C, typename M>
+constexpr auto hashField(uint64_t hash, const FieldDesc<C, M>& desc) -> uint64_t {
+    hash = hashString(hash, desc.name);
+    hash = hashBytes(hash, sizeof(M), 1);
+    hash = hashBytes(hash, std::is_floating_point_v<M> ? 1 : std::is_signed_v<M> ? 2 : 0, 1);
+    hash = hashBytes(hash, desc.bits, 1);
+    // ranges at 1/1024 resolution, floats can't be hashed bitwise in constexpr
+    hash = hashBytes(hash, static_cast<uint64_t>(static_cast<int64_t>(desc.min * 1024.0)), 8);
+    return hashBytes(hash, static_cast<uint64_t>(static_cast<int64_t>(desc.max * 1024.0)), 8);
+}
+
+template <typename C, typename M>
+constexpr auto validField(const FieldDesc<C, M>& desc) -> bool {
+    if constexpr (std::is_same_v<M, bool>)
+        return desc.bits == 1;
+    else if constexpr (std::is_floating_point_v<M>)
+        return desc.raw() ? desc.bits == 32 && sizeof(M) == 4 : desc.bits >= 1 && desc.bits <= 32 && desc.max > desc.min;
+    else
+        return std::is_integral_v<M> && desc.bits >= 1 && desc.bits <= sizeof(M) * 8;
+}
+
+} // namespace detail
+
+// components declaring `fields` in their traits can be serialized
+template <typename T>
+constexpr bool hasSchema = detail::has_fields_<T>::value;
+
+template <typename T>
+constexpr auto fieldsOf() -> const auto& {
+    static_assert(hasSchema<T>, "component has no field schema");
+    return ComponentTraits<T>::fields;
+}
+
+template <typename T>
+constexpr auto schemaValid() -> bool {
+    return std::apply([](const auto&... desc) { return (detail::validField(desc) && ...); }, fieldsOf<T>());
+}
+
+// bits of a full (non-delta) encoding
+template <typename T>
+constexpr auto schemaBits() -> std::size_t {
+    return std::apply([](const auto&... desc) { return (std::size_t{0} + ... + desc.bits); }, fieldsOf<T>());
+}
+
+// fn(desc) for every declared field, in declaration order
+template <typename T, typename F>
+constexpr void forEachField(F&& fn) {
+    std::apply([&](const auto&... desc) { (fn(desc), ...); }, fieldsOf<T>());
+}
+
+// covers the component id, name and every field's name, type and encoding:
+// two builds can exchange T only if they agree on its hash
+template <typename T>
+constexpr auto schemaHash() -> uint64_t {
+    static_assert(schemaValid<T>(), "invalid field schema");
+    auto hash = detail::hashBytes(detail::FNV_OFFSET, componentId<T>(), 4);
+    hash = detail::hashString(hash, ComponentTraits<T>::name);
+    return std::apply([hash](const auto&... desc) {
+        auto result = hash;
+        ((result = detail::hashField(result, desc)), ...);
+        return result;
+    }, fieldsOf<T>());
+}
+
+// hash of a whole protocol, order matters
+template <typename... Ts>
+constexpr auto combinedSchemaHash() -> uint64_t {
+    auto hash = detail::FNV_OFFSET;
+    ((hash = detail::hashBytes(hash, schemaHash<Ts>(), 8)), ...);
+    return hash;
+}
+
+} // namespace game
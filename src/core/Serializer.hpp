@@ -0,0 +1,126 @@
+#pragma once
+
+#include <cmath>
+#include <cstring>
+#include <ostream>
+
+#include "core/BitStream.hpp"
+#include "core/Schema.hpp"
+
+namespace game {
+
+// wire encoding of one field, see FieldDesc
+template <typename C, typename M>
+auto quantize(const FieldDesc<C, M>& desc, M value) -> uint64_t {
+    if constexpr (std::is_same_v<M, bool>) {
+        return value ? 1 : 0;
+    }
+    else if constexpr (std::is_floating_point_v<M>) {
+        if (desc.raw()) {
+            uint32_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            return bits;
+        }
+        double v = value;
+        // NaN ends up at min
+        if (!(v > desc.min))
+            v = desc.min;
+        if (v > desc.max)
+            v = desc.max;
+        return static_cast<uint64_t>(std::llround((v - desc.min) / (desc.max - desc.min) * desc.maxCode()));
+    }
+    else {
+        auto lo = static_cast<int64_t>(desc.min);
+        auto v = static_cast<int64_t>(value);
+        if (v < lo)
+            return 0;
+        auto code = static_cast<uint64_t>(v - lo);
+        return code > desc.maxCode() ? desc.maxCode() : code;
+    }
+}
+
+template <typename C, typename M>
+auto dequantize(const FieldDesc<C, M>& desc, uint64_t code) -> M {
+    if constexpr (std::is_same_v<M, bool>) {
+        return code != 0;
+    }
+    else if constexpr (std::is_floating_point_v<M>) {
+        if (desc.raw()) {
+            auto bits = static_cast<uint32_t>(code);
+            float value;
+            std::memcpy(&value, &bits, sizeof(value));
+            return value;
+        }
+        return static_cast<M>(desc.min + (desc.max - desc.min) * static_cast<double>(code) / desc.maxCode());
+    }
+    else {
+        return static_cast<M>(static_cast<int64_t>(desc.min) + static_cast<int64_t>(code));
+    }
+}
+
+// full encoding, schemaBits<T>() bits
+template <typename T>
+void serialize(BitWriter& out, const T& value) {
+    static_assert(schemaValid<T>(), "invalid field schema");
+    forEachField<T>([&](const auto& desc) { out.write(quantize(desc, value.*desc.member), desc.bits); });
+}
+
+// fields without a descriptor keep their default value
+template <typename T>
+auto deserialize(BitReader& in) -> T {
+    static_assert(schemaValid<T>(), "invalid field schema");
+    T value{};
+    forEachField<T>([&](const auto& desc) { value.*desc.member = dequantize(desc, in.read(desc.bits)); });
+    return value;
+}
+
+// one bit per field, followed by the field when its encoding differs from
+// the one of base. returns false if nothing changed, the receiver still has
+// to read the (all zero) flags.
+template <typename T>
+auto encodeDelta(BitWriter& out, const T& base, const T& value) -> bool {
+    static_assert(schemaValid<T>(), "invalid field schema");
+    bool changed = false;
+    forEachField<T>([&](const auto& desc) {
+        auto code = quantize(desc, value.*desc.member);
+        if (code == quantize(desc, base.*desc.member)) {
+            out.writeBool(false);
+            return;
+        }
+        out.writeBool(true);
+        out.write(code, desc.bits);
+        changed = true;
+    });
+    return changed;
+}
+
+template <typename T>
+auto decodeDelta(BitReader& in, const T& base) -> T {
+    static_assert(schemaValid<T>(), "invalid field schema");
+    T value = base;
+    forEachField<T>([&](const auto& desc) {
+        if (in.readBool())
+            value.*desc.member = dequantize(desc, in.read(desc.bits));
+    });
+    return value;
+}
+
+// debug inspector: writes "Name{field: value, ...}"
+template <typename T>
+void inspect(std::ostream& out, const T& value) {
+    out << ComponentTraits<T>::name << '{';
+    const char* separator = "";
+    forEachField<T>([&](const auto& desc) {
+        using Member = typename std::decay_t<decltype(desc)>::Member;
+        out << separator << desc.name << ": ";
+        // print small integers as numbers, not characters
+        if constexpr (std::is_integral_v<Member> && sizeof(Member) == 1 && !std::is_same_v<Member, bool>)
+            out << static_cast<int>(value.*desc.member);
+        else
+            out << value.*desc.member;
+        separator = ", ";
+    });
+    out << '}';
+}
+
+} // namespace game
@@ -0,0 +1,53 @@
+#include "core/Snapshot.hpp"
+
+#include <string>
+
+#include "core/World.hpp"
+
+namespace game {
+
+void SnapshotBuffer::reserve(std::size_t capacity) {
+    if (capacity <= m_capacity)
+        return;
+    // default-initialized, the bytes are always written before being read
+    std::unique_ptr<std::byte[]> data(new std::byte[capacity]);
+    if (m_size)
+        std::memcpy(data.get(), m_data.get(), m_size);
+    m_data = std::move(data);
+    m_capacity = capacity;
+}
+
+SnapshotRing::SnapshotRing(std::size_t slot_count, std::size_t slot_capacity) : m_slots(slot_count) {
+    if (slot_count == 0)
+        throw std::invalid_argument("snapshot ring needs at least one slot");
+    for (auto& slot : m_slots)
+        slot.buffer.reserve(slot_capacity);
+}
+
+void SnapshotRing::capture(const World& world) {
+    auto& slot = m_slots[world.tick() % m_slots.size()];
+    slot.used = false;
+    slot.buffer.clear();
+    world.saveSnapshot(slot.buffer);
+    slot.tick = world.tick();
+    slot.used = true;
+}
+
+auto SnapshotRing::contains(Tick tick) const -> bool {
+    const auto& stored = slot(tick);
+    return stored.used && stored.tick == tick;
+}
+
+void SnapshotRing::restore(World& world, Tick tick) {
+    if (!contains(tick))
+        throw std::out_of_range("no snapshot for tick " + std::to_string(tick));
+    auto& stored = m_slots[tick % m_slots.size()];
+    stored.buffer.rewind();
+    world.loadSnapshot(stored.buffer);
+}
+
+auto SnapshotRing::bytes(Tick tick) const -> std::size_t {
+    return contains(tick) ? slot(tick).buffer.size() : 0;
+}
+
+} // namespace game
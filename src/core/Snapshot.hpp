@@ -0,0 +1,104 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "common/types.hpp"
+
+namespace game {
+
+class World;
+
+// flat byte buffer a World snapshot is written to. clear() keeps the
+// capacity, so once a buffer has grown to the room size, capturing into it
+// again doesn't allocate.
+class SnapshotBuffer {
+public:
+    void clear() {
+        m_size = 0;
+        m_read = 0;
+    }
+    void reserve(std::size_t capacity);
+    auto size() const -> std::size_t { return m_size; }
+    auto capacity() const -> std::size_t { return m_capacity; }
+
+    void write(const void* data, std::size_t size) {
+        // empty arrays may come with a null data pointer
+        if (size == 0)
+            return;
+        if (m_size + size > m_capacity)
+            reserve(std::max(m_size + size, 2 * m_capacity));
+        std::memcpy(m_data.get() + m_size, data, size);
+        m_size += size;
+    }
+    template <typename T>
+    void write(const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>, "snapshots only hold trivially copyable data");
+        write(&value, sizeof(T));
+    }
+
+    // reads sequentially from the start, or from the last rewind()
+    void rewind() { m_read = 0; }
+    void read(void* data, std::size_t size) {
+        if (size == 0)
+            return;
+        if (m_read + size > m_size)
+            throw std::out_of_range("read past the end of the snapshot");
+        std::memcpy(data, m_data.get() + m_read, size);
+        m_read += size;
+    }
+    template <typename T>
+    auto read() -> T {
+        static_assert(std::is_trivially_copyable_v<T>, "snapshots only hold trivially copyable data");
+        T value;
+        read(&value, sizeof(T));
+        return value;
+    }
+
+private:
+    std::unique_ptr<std::byte[]> m_data;
+    std::size_t m_size = 0;
+    std::size_t m_capacity = 0;
+    std::size_t m_read = 0;
+};
+
+// the last N ticks of a World for rollback and lag compensation. slot
+// buffers are preallocated and reused: capturing copies every archetype
+// chunk wholesale, restoring copies them back, so all stored components
+// must be trivially copyable. a snapshot only restores into the World it was
+// taken from, and not after that World has been cleared.
+class SnapshotRing {
+public:
+    // slot_capacity preallocates every slot, 0 lets them grow on first use
+    explicit SnapshotRing(std::size_t slot_count, std::size_t slot_capacity = 0);
+
+    // stores the World state of world.tick(), replacing the snapshot taken
+    // slot_count ticks earlier
+    void capture(const World& world);
+    auto contains(Tick tick) const -> bool;
+    // puts the World back in the state it had at tick, World::tick() included.
+    // throws std::out_of_range if that tick is no longer in the ring.
+    void restore(World& world, Tick tick);
+
+    auto slotCount() const -> std::size_t { return m_slots.size(); }
+    // size of the snapshot stored for tick, 0 if there is none
+    auto bytes(Tick tick) const -> std::size_t;
+
+private:
+    struct Slot {
+        Tick tick = 0;
+        bool used = false;
+        SnapshotBuffer buffer;
+    };
+
+    auto slot(Tick tick) const -> const Slot& { return m_slots[tick % m_slots.size()]; }
+
+    std::vector<Slot> m_slots;
+};
+
+} // namespace game
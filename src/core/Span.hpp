@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>
+
+namespace game {
+
+// non-owning view over a contiguous array (std::span is C++20)
+template <typename T>
+class Span {
+public:
+    Span() = default;
+    Span(T* data, std::size_t size) : m_data(data), m_size(size) {}
+
+    auto data() const -> T* { return m_data; }
+    auto size() const -> std::size_t { return m_size; }
+    auto empty() const -> bool { return m_size == 0; }
+
+    auto operator[](std::size_t i) const -> T& { return m_data[i]; }
+    auto begin() const -> T* { return m_data; }
+    auto end() const -> T* { return m_data + m_size; }
+
+private:
+    T* m_data = nullptr;
+    std::size_t m_size = 0;
+};
+
+} // namespace game
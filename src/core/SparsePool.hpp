@@ -0,0 +1,194 @@
+#pragma once
+
+#include <algorithm>
+#include <memory_resource>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "core/Component.hpp"
+#include "core/Entity.hpp"
+#include "core/Snapshot.hpp"
+
+namespace game {
+
+// type-erased part of a sparse-set pool, lets the World drop an entity's
+// sparse components without knowing their types
+class SparsePoolBase {
+public:
+    explicit SparsePoolBase(std::pmr::memory_resource* resource) : m_sparse(resource), m_dense(resource) {}
+    SparsePoolBase(const SparsePoolBase&) = delete;
+    auto operator=(const SparsePoolBase&) -> SparsePoolBase& = delete;
+    virtual ~SparsePoolBase() { releasePages(); }
+
+    auto contains(EntityID entity) const -> bool {
+        auto index = denseIndex(entity);
+        return index != NONE && m_dense[index] == entity;
+    }
+    auto size() const -> std::size_t { return m_dense.size(); }
+    // packed, in the same order as the component array
+    auto entities() const -> const EntityID* { return m_dense.data(); }
+
+    virtual void remove(EntityID entity) = 0;
+    virtual void clear() = 0;
+    // snapshot of the packed arrays, see SnapshotRing
+    virtual void save(SnapshotBuffer& out) const = 0;
+    virtual void load(SnapshotBuffer& in) = 0;
+
+protected:
+    static constexpr uint32_t PAGE_BITS = 12;
+    static constexpr uint32_t PAGE_SIZE = 1u << PAGE_BITS;
+    static constexpr uint32_t NONE = ~0u;
+
+    auto denseIndex(EntityID entity) const -> uint32_t {
+        auto index = entityIndex(entity);
+        auto page = index >> PAGE_BITS;
+        if (page >= m_sparse.size() || !m_sparse[page])
+            return NONE;
+        return m_sparse[page][index & (PAGE_SIZE - 1)];
+    }
+    auto sparseSlot(EntityID entity) -> uint32_t& {
+        auto index = entityIndex(entity);
+        auto page = index >> PAGE_BITS;
+        if (page >= m_sparse.size())
+            m_sparse.resize(page + 1);
+        if (!m_sparse[page]) {
+            auto* resource = m_sparse.get_allocator().resource();
+            m_sparse[page] = static_cast<uint32_t*>(resource->allocate(PAGE_SIZE * sizeof(uint32_t), alignof(uint32_t)));
+            std::fill_n(m_sparse[page], PAGE_SIZE, NONE);
+        }
+        return m_sparse[page][index & (PAGE_SIZE - 1)];
+    }
+    void releasePages() {
+        auto* resource = m_sparse.get_allocator().resource();
+        for (auto* page : m_sparse) {
+            if (page)
+                resource->deallocate(page, PAGE_SIZE * sizeof(uint32_t), alignof(uint32_t));
+        }
+        m_sparse.clear();
+    }
+
+    // sparse pages are allocated lazily, indexed by entityIndex()
+    std::pmr::vector<uint32_t*> m_sparse;
+    std::pmr::vector<EntityID> m_dense;
+};
+
+// sparse-set storage for one component type: O(1) add/remove/lookup and a
+// packed component array that can be iterated without any per-entity check
+template <typename T>
+class SparsePool final : public SparsePoolBase {
+public:
+    explicit SparsePool(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+    : SparsePoolBase(resource), m_data(resource), m_ticks(resource) {}
+
+    auto emplace(EntityID entity, T component, Tick tick) -> T& {
+        auto& slot = sparseSlot(entity);
+        if (slot != NONE && m_dense[slot] == entity) {
+            m_data[slot] = std::move(component);
+            m_ticks[slot] = tick;
+            return m_data[slot];
+        }
+        slot = static_cast<uint32_t>(m_dense.size());
+        m_dense.push_back(entity);
+        m_ticks.push_back(tick);
+        return m_data.emplace_back(std::move(component));
+    }
+
+    void remove(EntityID entity) override {
+        auto index = denseIndex(entity);
+        if (index == NONE || m_dense[index] != entity)
+            return;
+
+        // swap with the last element to keep the arrays packed
+        auto last = static_cast<uint32_t>(m_dense.size() - 1);
+        if (index != last) {
+            m_dense[index] = m_dense[last];
+            m_data[index] = std::move(m_data[last]);
+            m_ticks[index] = m_ticks[last];
+            sparseSlot(m_dense[index]) = index;
+        }
+        sparseSlot(entity) = NONE;
+        m_dense.pop_back();
+        m_data.pop_back();
+        m_ticks.pop_back();
+    }
+
+    void clear() override {
+        releasePages();
+        m_dense.clear();
+        m_data.clear();
+        m_ticks.clear();
+    }
+
+    void save(SnapshotBuffer& out) const override {
+        if constexpr (!std::is_trivially_copyable_v<T>) {
+            if (!m_dense.empty())
+                throw std::invalid_argument(std::string("component ") + ComponentTraits<T>::name +
+                                            " is not trivially copyable");
+            out.write(std::size_t{0});
+        }
+        else {
+            out.write(m_dense.size());
+            out.write(m_dense.data(), m_dense.size() * sizeof(EntityID));
+            out.write(m_data.data(), m_data.size() * sizeof(T));
+            out.write(m_ticks.data(), m_ticks.size() * sizeof(Tick));
+        }
+    }
+
+    void load(SnapshotBuffer& in) override {
+        if constexpr (!std::is_trivially_copyable_v<T>) {
+            // save() only ever stores an empty pool
+            in.read<std::size_t>();
+            clear();
+        }
+        else {
+            for (auto entity : m_dense)
+                sparseSlot(entity) = NONE;
+            auto count = in.read<std::size_t>();
+            m_dense.resize(count);
+            m_data.resize(count);
+            m_ticks.resize(count);
+            in.read(m_dense.data(), count * sizeof(EntityID));
+            in.read(m_data.data(), count * sizeof(T));
+            in.read(m_ticks.data(), count * sizeof(Tick));
+            for (uint32_t i = 0; i < count; ++i)
+                sparseSlot(m_dense[i]) = i;
+        }
+    }
+
+    auto tryGet(EntityID entity) -> T* {
+        auto index = denseIndex(entity);
+        return index != NONE && m_dense[index] == entity ? &m_data[index] : nullptr;
+    }
+    // like tryGet, but records the access as a write on the given tick
+    auto tryWrite(EntityID entity, Tick tick) -> T* {
+        auto index = denseIndex(entity);
+        if (index == NONE || m_dense[index] != entity)
+            return nullptr;
+        m_ticks[index] = tick;
+        return &m_data[index];
+    }
+
+    auto data() -> T* { return m_data.data(); }
+    auto data() const -> const T* { return m_data.data(); }
+    // tick of the last write, parallel to data()
+    auto ticks() const -> const Tick* { return m_ticks.data(); }
+
+    // fn(EntityID, T&) over the packed arrays
+    template <typename F>
+    void each(F&& fn) {
+        auto* entities = m_dense.data();
+        auto* data = m_data.data();
+        auto count = m_dense.size();
+        for (std::size_t i = 0; i < count; ++i)
+            fn(entities[i], data[i]);
+    }
+
+private:
+    std::pmr::vector<T> m_data;
+    std::pmr::vector<Tick> m_ticks;
+};
+
+} // namespace game
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "core/CommandBuffer.hpp"
+#include "core/JobSystem.hpp"
+
+namespace game {
+
+// components, resources and events a system reads and writes during
+// update(). two systems whose accesses don't conflict may run at the same
+// time. sending counts as a write, so the events of one tick are queued in
+// system order, and a receiver runs after the senders added before it.
+struct SystemAccess {
+    Signature reads;
+    Signature writes;
+    ResourceSet resource_reads;
+    ResourceSet resource_writes;
+    EventSet sends;
+    EventSet receives;
+    // exclusive systems run alone, e.g. because they change the World
+    // structure directly instead of through their command buffers
+    bool exclusive = false;
+
+    auto conflictsWith(const SystemAccess& other) const -> bool {
+        if (exclusive || other.exclusive)
+            return true;
+        return (writes & (other.reads | other.writes)).any() || (other.writes & reads).any() ||
+               (resource_writes & (other.resource_reads | other.resource_writes)).any() ||
+               (other.resource_writes & resource_reads).any() ||
+               (sends & (other.sends | other.receives)).any() || (other.sends & receives).any();
+    }
+};
+
+class System {
+public:
+    explicit System(const char* name) : m_name(name) {}
+    virtual ~System() = default;
+
+    // called once when the system is added, the place to create queries
+    virtual void init(World& /*world*/) {}
+    virtual void update(World& world, float dt) = 0;
+
+    auto name() const -> const char* { return m_name; }
+    auto access() const -> const SystemAccess& { return m_access; }
+    // structural changes recorded by update() itself, not by the tasks of a
+    // parallel pass (those use the parallelForEachChunk() and parallelEach()
+    // below). the SystemManager plays every buffer back once every system of
+    // the update has run, in the order they were recorded.
+    auto commands() -> CommandBuffer& { return group(m_serial, 1).front(); }
+
+protected:
+    // to be called from the constructor
+    template <typename... Ts>
+    void reads() { m_access.reads |= signatureOf<Ts...>(); }
+    template <typename... Ts>
+    void writes() { m_access.writes |= signatureOf<Ts...>(); }
+    template <typename... Rs>
+    void readsResources() { m_access.resource_reads |= resourceSetOf<Rs...>(); }
+    template <typename... Rs>
+    void writesResources() { m_access.resource_writes |= resourceSetOf<Rs...>(); }
+    // also registers the event types with the World, see World::events()
+    template <typename... Es>
+    void sends() {
+        m_access.sends |= eventSetOf<Es...>();
+        (m_event_types.push_back(&registerEvent<Es>), ...);
+    }
+    template <typename... Es>
+    void receives() {
+        m_access.receives |= eventSetOf<Es...>();
+        (m_event_types.push_back(&registerEvent<Es>), ...);
+    }
+    void exclusive() { m_access.exclusive = true; }
+
+    // Query::parallelForEachChunk() and parallelEach() with a command buffer
+    // per task, played back after what commands() recorded so far and before
+    // what it records next
+    template <typename F>
+    void parallelForEachChunk(const Query& query, ThreadPool* pool, std::size_t min_grain, F&& fn) {
+        query.parallelForEachChunk(pool, min_grain, passCommands(query.taskCount(pool, min_grain)),
+                                   std::forward<F>(fn));
+    }
+    template <typename... Ts, typename F>
+    void parallelEach(const Query& query, ThreadPool* pool, std::size_t min_grain, F&& fn) {
+        query.parallelEach<Ts...>(pool, min_grain, passCommands(query.taskCount(pool, min_grain)),
+                                  std::forward<F>(fn));
+    }
+
+private:
+    friend class SystemManager;
+
+    // buffers for a pass of `count` tasks, commands() moves on to a fresh
+    // buffer behind them
+    auto passCommands(std::size_t count) -> Span<CommandBuffer> {
+        // the next serial group first, growing m_commands moves the groups
+        group(m_serial + 2, 1);
+        auto& pass = group(m_serial + 1, count);
+        m_serial += 2;
+        return {pass.data(), count};
+    }
+    auto group(std::size_t index, std::size_t count) -> std::vector<CommandBuffer>& {
+        if (m_commands.size() <= index)
+            m_commands.resize(index + 1);
+        if (m_commands[index].size() < count)
+            m_commands[index].resize(count);
+        return m_commands[index];
+    }
+    // called by the SystemManager after update()
+    void playbackCommands(World& world) {
+        for (std::size_t i = 0; i <= m_serial && i < m_commands.size(); ++i) {
+            for (auto& commands : m_commands[i])
+                commands.playback(world);
+        }
+        m_serial = 0;
+    }
+    // called by the SystemManager before init()
+    void registerEvents(World& world) {
+        for (auto* register_event : m_event_types)
+            register_event(world);
+    }
+    template <typename E>
+    static void registerEvent(World& world) { world.registerEvent<E>(); }
+
+    const char* m_name;
+    SystemAccess m_access;
+    // recording order: a group for commands(), then for every parallel pass
+    // a group of per-task buffers and a new one for commands(). groups are
+    // kept between updates, m_serial is the group commands() records into
+    std::vector<std::vector<CommandBuffer>> m_commands;
+    std::size_t m_serial = 0;
+    std::vector<void (*)(World&)> m_event_types;
+};
+
+} // namespace game
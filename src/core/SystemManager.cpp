@@ -0,0 +1,74 @@
+#include "core/SystemManager.hpp"
+
+#include <chrono>
+
+namespace game {
+
+void SystemManager::update(float dt) {
+    auto start = std::chrono::steady_clock::now();
+    m_profiler.beginTick(m_world.tick());
+
+    if (!m_pool || m_systems.size() <= 1) {
+        for (std::size_t i = 0; i < m_systems.size(); ++i)
+            run(i, dt);
+    }
+    else {
+        buildGraph();
+        TaskGroup group;
+        for (std::size_t i = 0; i < m_systems.size(); ++i) {
+            if (m_dependency_count[i] == 0)
+                launch(i, group, dt);
+        }
+        m_pool->wait(group);
+    }
+    playbackCommands();
+    m_world.swapEvents();
+
+    m_profiler.endTick(std::chrono::duration_cast<Microseconds>(std::chrono::steady_clock::now() - start));
+}
+
+void SystemManager::run(std::size_t index, float dt) {
+    auto start = std::chrono::steady_clock::now();
+    m_systems[index]->update(m_world, dt);
+    m_profiler.recordSystem(index, std::chrono::duration_cast<Microseconds>(std::chrono::steady_clock::now() - start));
+}
+
+void SystemManager::playbackCommands() {
+    for (auto& system : m_systems)
+        system->playbackCommands(m_world);
+}
+
+void SystemManager::buildGraph() {
+    auto count = m_systems.size();
+    m_dependents.resize(count);
+    for (auto& dependents : m_dependents)
+        dependents.clear();
+    m_dependency_count.assign(count, 0);
+
+    for (std::size_t i = 0; i < count; ++i) {
+        const auto& access = m_systems[i]->access();
+        for (std::size_t j = 0; j < i; ++j) {
+            if (access.conflictsWith(m_systems[j]->access())) {
+                m_dependents[j].push_back(i);
+                ++m_dependency_count[i];
+            }
+        }
+    }
+
+    m_remaining = std::make_unique<std::atomic<int>[]>(count);
+    for (std::size_t i = 0; i < count; ++i)
+        m_remaining[i].store(m_dependency_count[i], std::memory_order_relaxed);
+}
+
+void SystemManager::launch(std::size_t index, TaskGroup& group, float dt) {
+    m_pool->run(group, [this, index, &group, dt] {
+        run(index, dt);
+        // the last dependency to finish starts the dependent system
+        for (auto dependent : m_dependents[index]) {
+            if (m_remaining[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1)
+                launch(dependent, group, dt);
+        }
+    });
+}
+
+} // namespace game
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "core/JobSystem.hpp"
+#include "core/Profiler.hpp"
+#include "core/System.hpp"
+
+namespace game {
+
+// runs the systems of one World. every update() builds a dependency graph
+// from the declared accesses: a system depends on each earlier-added system
+// it conflicts with, so the result is the same as running them serially in
+// the order they were added, while non-conflicting systems run concurrently
+// on the thread pool. the systems' command buffers are played back at the
+// end of update(), in the order the systems were added and for each system
+// in recording order, then the events sent during the update become readable
+// for the next one. every system call is timed into the manager's TickProfiler.
+class SystemManager {
+public:
+    // without a pool every system runs on the calling thread
+    explicit SystemManager(World& world, ThreadPool* pool = nullptr) : m_world(world), m_pool(pool) {}
+
+    template <typename T, typename... Args>
+    auto add(Args&&... args) -> T&;
+
+    void update(float dt);
+
+    auto systems() const -> const std::vector<std::unique_ptr<System>>& { return m_systems; }
+    auto profiler() -> TickProfiler& { return m_profiler; }
+    auto profiler() const -> const TickProfiler& { return m_profiler; }
+
+private:
+    void buildGraph();
+    void playbackCommands();
+    void launch(std::size_t index, TaskGroup& group, float dt);
+    void run(std::size_t index, float dt);
+
+    World& m_world;
+    ThreadPool* m_pool;
+    std::vector<std::unique_ptr<System>> m_systems;
+    TickProfiler m_profiler;
+
+    // per-update dependency graph
+    std::vector<std::vector<std::size_t>> m_dependents;
+    std::vector<int> m_dependency_count;
+    std::unique_ptr<std::atomic<int>[]> m_remaining;
+};
+
+template <typename T, typename... Args>
+auto SystemManager::add(Args&&... args) -> T& {
+    auto system = std::make_unique<T>(std::forward<Args>(args)...);
+    auto& ref = *system;
+    ref.registerEvents(m_world);
+    ref.init(m_world);
+    m_systems.push_back(std::move(system));
+    m_profiler.addSystem(ref.name());
+    return ref;
+}
+
+} // namespace game
@@ -0,0 +1,172 @@
+#include "core/TimerWheel.hpp"
+
+#include <algorithm>
+
+#include "core/Bits.hpp"
+
+namespace game {
+
+namespace {
+
+constexpr auto levelShift(unsigned level) -> unsigned {
+    return TimerWheel::WHEEL_BITS * level;
+}
+
+// ticks spanned by one slot of the level above the top one
+constexpr Tick OVERFLOW_SPAN = Tick(1) << levelShift(TimerWheel::WHEEL_LEVELS);
+
+} // namespace
+
+TimerWheel::TimerWheel(Tick now, std::pmr::memory_resource* resource)
+: m_now(now), m_nodes(resource), m_free(resource), m_expired(resource) {
+    m_heads.fill(NIL);
+}
+
+auto TimerWheel::schedule(Tick due, EntityID entity, TimerKind kind) -> TimerHandle {
+    uint32_t index;
+    if (!m_free.empty()) {
+        index = m_free.back();
+        m_free.pop_back();
+    }
+    else {
+        index = static_cast<uint32_t>(m_nodes.size());
+        m_nodes.emplace_back();
+    }
+
+    auto& node = m_nodes[index];
+    node.due = std::max(due, m_now + 1);
+    node.entity = entity;
+    node.kind = kind;
+    link(index, listFor(node.due));
+    ++m_size;
+    return handleOf(index);
+}
+
+auto TimerWheel::pending(TimerHandle handle) const -> bool {
+    auto index = static_cast<uint32_t>(handle);
+    return index < m_nodes.size() && m_nodes[index].list != NIL &&
+           m_nodes[index].generation == static_cast<uint32_t>(handle >> 32);
+}
+
+auto TimerWheel::cancel(TimerHandle handle) -> bool {
+    if (!pending(handle))
+        return false;
+    auto index = static_cast<uint32_t>(handle);
+    unlink(index);
+    release(index);
+    return true;
+}
+
+auto TimerWheel::advance(Tick now) -> Span<const Timer> {
+    m_expired.clear();
+    while (m_now < now) {
+        // nothing left to fire, skip the remaining ticks at once
+        if (m_size == 0) {
+            m_now = now;
+            break;
+        }
+        // next occupied slot of level 0 in the current turn, or the start
+        // of the next turn where the levels above cascade
+        auto offset = static_cast<unsigned>(m_now & (WHEEL_SLOTS - 1));
+        auto occupied = offset + 1 < WHEEL_SLOTS ? m_occupied[0] >> (offset + 1) << (offset + 1) : 0;
+        auto turn = m_now & ~Tick(WHEEL_SLOTS - 1);
+        auto next = occupied ? turn + lowestBit(occupied) : turn + WHEEL_SLOTS;
+        if (next > now) {
+            m_now = now;
+            break;
+        }
+        m_now = next;
+        // entering a slot of a higher level: move its timers down, the
+        // highest level first so they can keep moving down this same tick
+        if (m_now % OVERFLOW_SPAN == 0)
+            cascade(OVERFLOW_LIST);
+        for (auto level = WHEEL_LEVELS - 1; level > 0; --level) {
+            auto span = Tick(1) << levelShift(level);
+            if (m_now % span == 0)
+                cascade(level * WHEEL_SLOTS + ((m_now >> levelShift(level)) & (WHEEL_SLOTS - 1)));
+        }
+        fire(m_now);
+    }
+    return {m_expired.data(), m_expired.size()};
+}
+
+void TimerWheel::clear(Tick now) {
+    for (uint32_t index = 0; index < m_nodes.size(); ++index) {
+        if (m_nodes[index].list != NIL)
+            release(index);
+    }
+    m_heads.fill(NIL);
+    m_occupied.fill(0);
+    m_expired.clear();
+    m_now = now;
+}
+
+auto TimerWheel::listFor(Tick due) const -> uint32_t {
+    for (unsigned level = 0; level < WHEEL_LEVELS; ++level) {
+        if (due >> levelShift(level + 1) == m_now >> levelShift(level + 1))
+            return level * WHEEL_SLOTS + static_cast<uint32_t>((due >> levelShift(level)) & (WHEEL_SLOTS - 1));
+    }
+    return OVERFLOW_LIST;
+}
+
+void TimerWheel::link(uint32_t index, uint32_t list) {
+    auto& node = m_nodes[index];
+    node.list = list;
+    node.prev = NIL;
+    node.next = m_heads[list];
+    if (node.next != NIL)
+        m_nodes[node.next].prev = index;
+    m_heads[list] = index;
+    if (list != OVERFLOW_LIST)
+        m_occupied[list / WHEEL_SLOTS] |= uint64_t(1) << (list % WHEEL_SLOTS);
+}
+
+void TimerWheel::unlink(uint32_t index) {
+    auto& node = m_nodes[index];
+    if (node.prev != NIL)
+        m_nodes[node.prev].next = node.next;
+    else
+        m_heads[node.list] = node.next;
+    if (m_heads[node.list] == NIL && node.list != OVERFLOW_LIST)
+        m_occupied[node.list / WHEEL_SLOTS] &= ~(uint64_t(1) << (node.list % WHEEL_SLOTS));
+    if (node.next != NIL)
+        m_nodes[node.next].prev = node.prev;
+}
+
+void TimerWheel::release(uint32_t index) {
+    auto& node = m_nodes[index];
+    node.list = NIL;
+    ++node.generation;
+    m_free.push_back(index);
+    --m_size;
+}
+
+auto TimerWheel::takeList(uint32_t list) -> uint32_t {
+    auto head = m_heads[list];
+    m_heads[list] = NIL;
+    if (list != OVERFLOW_LIST)
+        m_occupied[list / WHEEL_SLOTS] &= ~(uint64_t(1) << (list % WHEEL_SLOTS));
+    return head;
+}
+
+void TimerWheel::cascade(uint32_t list) {
+    auto index = takeList(list);
+    while (index != NIL) {
+        auto next = m_nodes[index].next;
+        link(index, listFor(m_nodes[index].due));
+        index = next;
+    }
+}
+
+void TimerWheel::fire(Tick tick) {
+    auto index = takeList(static_cast<uint32_t>(tick & (WHEEL_SLOTS - 1)));
+    while (index != NIL) {
+        auto& node = m_nodes[index];
+        auto next = node.next;
+        m_expired.push_back({handleOf(index), node.due, node.entity, node.kind});
+        release(index);
+        index = next;
+    }
+}
+
+} // namespace game
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <memory_resource>
+#include <vector>
+
+#include "common/types.hpp"
+#include "core/Span.hpp"
+
+namespace game {
+
+// generational handle to a scheduled timer: low 32 bits index the timer
+// slot, high 32 bits its generation, so a handle to a timer that already
+// fired or was cancelled stays invalid after the slot is reused
+using TimerHandle = uint64_t;
+constexpr TimerHandle INVALID_TIMER = std::numeric_limits<TimerHandle>::max();
+
+// what a timer is for, a game-defined tag (respawn, weapon cooldown, buff
+// expiry, room timeout...) handed back on expiry along with the entity
+using TimerKind = uint32_t;
+
+struct Timer {
+    TimerHandle handle = INVALID_TIMER;
+    Tick due = 0;
+    EntityID entity = INVALID_ENTITY;
+    TimerKind kind = 0;
+};
+
+// hierarchical timer wheel indexed by Tick. schedule() and cancel() are
+// O(1); advance() fires everything due up to a tick as one batch, and only
+// touches the occupied wheel slots the ticks pass through, never the
+// pending timers that aren't due.
+//
+// level L has WHEEL_SLOTS slots of WHEEL_SLOTS^L ticks each. a timer sits on
+// the lowest level whose span holds both its due tick and the current one,
+// and moves down a level each time the wheel enters its slot; those due
+// further than the top level covers (about 77 hours at 60 Hz) wait in an
+// overflow list.
+class TimerWheel {
+public:
+    static constexpr unsigned WHEEL_BITS = 6;
+    static constexpr unsigned WHEEL_SLOTS = 1u << WHEEL_BITS;
+    static constexpr unsigned WHEEL_LEVELS = 4;
+    static_assert(WHEEL_SLOTS <= 64, "slot occupancy is a 64-bit mask");
+
+    // now is the last tick considered fired
+    explicit TimerWheel(Tick now = 0, std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    // fires on the first advance() reaching due; a due tick not after now()
+    // fires on the next advance()
+    auto schedule(Tick due, EntityID entity, TimerKind kind = 0) -> TimerHandle;
+    auto scheduleIn(Tick delay, EntityID entity, TimerKind kind = 0) -> TimerHandle {
+        return schedule(m_now + delay, entity, kind);
+    }
+    // returns false if the timer already fired or was cancelled
+    auto cancel(TimerHandle handle) -> bool;
+    auto pending(TimerHandle handle) const -> bool;
+
+    // fires every timer due in (now(), now], ordered by due tick. the
+    // returned timers stay valid until the next advance().
+    auto advance(Tick now) -> Span<const Timer>;
+
+    auto now() const -> Tick { return m_now; }
+    auto size() const -> std::size_t { return m_size; }
+    // drops every timer, handles given out so far become invalid
+    void clear(Tick now = 0);
+
+private:
+    static constexpr uint32_t NIL = std::numeric_limits<uint32_t>::max();
+    // list heads: the wheel slots level by level, then the overflow list
+    static constexpr uint32_t OVERFLOW_LIST = WHEEL_LEVELS * WHEEL_SLOTS;
+
+    struct Node {
+        Tick due = 0;
+        EntityID entity = INVALID_ENTITY;
+        TimerKind kind = 0;
+        uint32_t generation = 0;
+        uint32_t prev = NIL;
+        uint32_t next = NIL;
+        // NIL when the slot is free
+        uint32_t list = NIL;
+    };
+
+    auto handleOf(uint32_t index) const -> TimerHandle {
+        return TimerHandle(m_nodes[index].generation) << 32 | index;
+    }
+    auto listFor(Tick due) const -> uint32_t;
+    void link(uint32_t index, uint32_t list);
+    void unlink(uint32_t index);
+    void release(uint32_t index);
+    // detaches a whole list, returns its first node
+    auto takeList(uint32_t list) -> uint32_t;
+    // re-files every timer of a list against the current tick
+    void cascade(uint32_t list);
+    void fire(Tick tick);
+
+    Tick m_now;
+    std::size_t m_size = 0;
+    std::pmr::vector<Node> m_nodes;
+    std::pmr::vector<uint32_t> m_free;
+    std::array<uint32_t, OVERFLOW_LIST + 1> m_heads;
+    // bit s of level L set when that slot's list is not empty
+    std::array<uint64_t, WHEEL_LEVELS> m_occupied{};
+    std::pmr::vector<Timer> m_expired;
+};
+
+} // namespace game
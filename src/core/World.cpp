@@ -0,0 +1,300 @@
+#include "core/World.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <tuple>
+
+namespace game {
+
+namespace {
+
+// terminates the sparse pool list of a snapshot
+constexpr ComponentTypeID END_OF_POOLS = ~ComponentTypeID{0};
+
+} // namespace
+
+World::World() {
+    ComponentRegistry::registerDefaults();
+    m_root_archetype = archetypeFor(Signature{});
+}
+
+World::~World() {
+    destroyStorage();
+    for (auto* queue : m_event_queues) {
+        if (queue)
+            m_persistent_arena.destroy(queue);
+    }
+    for (auto& slot : m_resources) {
+        if (slot.data)
+            slot.destroy(slot.data);
+    }
+}
+
+void World::clear() {
+    destroyStorage();
+    // the containers are re-created empty rather than cleared, their storage
+    // is about to be reused by the arena
+    m_archetype_map = std::pmr::unordered_map<Signature, Archetype*>(&m_arena);
+    m_archetypes = std::pmr::vector<Archetype*>(&m_arena);
+    m_records = std::pmr::vector<EntityRecord>(&m_arena);
+    m_entities.clear();
+    for (auto& query : m_queries)
+        query->reset();
+    m_sparse_pools.fill(nullptr);
+    for (auto* queue : m_event_queues) {
+        if (queue)
+            queue->reset();
+    }
+    for (auto& slot : m_resources) {
+        if (slot.data)
+            slot.reset(slot.data);
+    }
+    m_chunk_allocator.reset();
+    m_arena.reset();
+
+    m_tick = 0;
+    ++m_epoch;
+    m_root_archetype = archetypeFor(Signature{});
+}
+
+void World::destroyStorage() {
+    // archetypes of trivially destructible components own nothing but arena
+    // memory, skipping them keeps teardown independent of the entity count
+    for (auto* archetype : m_archetypes) {
+        if (!archetype->trivial())
+            m_arena.destroy(archetype);
+    }
+    for (auto* pool : m_sparse_pools) {
+        if (pool)
+            m_arena.destroy(pool);
+    }
+}
+
+void World::swapEvents() {
+    for (auto* queue : m_event_queues) {
+        if (queue)
+            queue->swap(m_tick);
+    }
+}
+
+auto World::createEntity() -> EntityID {
+    auto entity = m_entities.create();
+    if (m_records.size() < m_entities.slotCount())
+        m_records.resize(m_entities.slotCount());
+
+    auto& rec = m_records[entityIndex(entity)];
+    rec.archetype = m_root_archetype;
+    std::tie(rec.chunk, rec.row) = m_root_archetype->pushRow(entity);
+    return entity;
+}
+
+void World::instantiateRows(const Prefab& prefab, Span<EntityID> out, const InstanceColumn* columns,
+                            std::size_t column_count) {
+    auto* archetype = archetypeFor(prefab.signature());
+    for (auto& entity : out)
+        entity = m_entities.create();
+    if (m_records.size() < m_entities.slotCount())
+        m_records.resize(m_entities.slotCount());
+
+    std::size_t done = 0;
+    archetype->pushRows(out.data(), out.size(), [&](uint32_t chunk_index, uint32_t first, uint32_t count) {
+        auto& chunk = archetype->chunks()[chunk_index];
+        for (const auto& col : archetype->columns()) {
+            auto id = col.info->id;
+            auto size = col.info->size;
+            auto* dst = static_cast<std::byte*>(archetype->componentData(chunk, id, first));
+            const void* values = nullptr;
+            for (std::size_t i = 0; i < column_count; ++i) {
+                if (columns[i].id == id)
+                    values = static_cast<const std::byte*>(columns[i].values) + done * size;
+            }
+            if (values) {
+                std::memcpy(dst, values, count * size);
+            }
+            else {
+                // one copy of the default, then double the filled range
+                std::memcpy(dst, prefab.defaults(id), size);
+                for (std::size_t filled = 1; filled < count;) {
+                    auto n = std::min<std::size_t>(filled, count - filled);
+                    std::memcpy(dst + filled * size, dst, n * size);
+                    filled += n;
+                }
+            }
+            archetype->stampRows(chunk, id, first, count, m_tick);
+        }
+        for (uint32_t row = 0; row < count; ++row)
+            m_records[entityIndex(out[done + row])] = {archetype, chunk_index, first + row};
+        done += count;
+    });
+}
+
+void World::destroyEntity(EntityID entity) {
+    auto& rec = record(entity);
+    auto moved = rec.archetype->removeRow(rec.chunk, rec.row, true);
+    if (moved != INVALID_ENTITY) {
+        m_records[entityIndex(moved)].chunk = rec.chunk;
+        m_records[entityIndex(moved)].row = rec.row;
+    }
+    rec = EntityRecord{};
+    for (auto& pool : m_sparse_pools) {
+        if (pool)
+            pool->remove(entity);
+    }
+    m_entities.destroy(entity, static_cast<SequenceNumber>(m_tick));
+}
+
+auto World::signature(EntityID entity) const -> Signature {
+    auto signature = record(entity).archetype->signature();
+    for (ComponentTypeID id = 0; id < MAX_COMPONENTS; ++id) {
+        if (m_sparse_pools[id] && m_sparse_pools[id]->contains(entity))
+            signature.set(id);
+    }
+    return signature;
+}
+
+void World::saveSnapshot(SnapshotBuffer& out) const {
+    // records hold archetype pointers, only this World can make sense of them
+    out.write(this);
+    out.write(m_epoch);
+    out.write(m_tick);
+    m_entities.save(out);
+    out.write(m_records.size());
+    out.write(m_records.data(), m_records.size() * sizeof(EntityRecord));
+
+    out.write(m_archetypes.size());
+    for (auto* archetype : m_archetypes)
+        archetype->save(out);
+
+    for (ComponentTypeID id = 0; id < MAX_COMPONENTS; ++id) {
+        if (!m_sparse_pools[id])
+            continue;
+        out.write(id);
+        m_sparse_pools[id]->save(out);
+    }
+    out.write(END_OF_POOLS);
+}
+
+void World::loadSnapshot(SnapshotBuffer& in) {
+    if (in.read<const World*>() != this)
+        throw std::invalid_argument("snapshot was taken from another World");
+    if (in.read<uint64_t>() != m_epoch)
+        throw std::invalid_argument("snapshot was taken before the World was cleared");
+    m_tick = in.read<Tick>();
+    m_entities.load(in);
+    m_records.resize(in.read<std::size_t>());
+    in.read(m_records.data(), m_records.size() * sizeof(EntityRecord));
+
+    // archetypes are never destroyed outside clear(), so the snapshot's
+    // archetypes are a prefix of the current ones
+    auto archetype_count = in.read<std::size_t>();
+    for (std::size_t i = 0; i < m_archetypes.size(); ++i) {
+        if (i < archetype_count)
+            m_archetypes[i]->load(in);
+        else
+            m_archetypes[i]->clear();
+    }
+
+    Signature loaded;
+    for (auto id = in.read<ComponentTypeID>(); id != END_OF_POOLS; id = in.read<ComponentTypeID>()) {
+        m_sparse_pools[id]->load(in);
+        loaded.set(id);
+    }
+    for (ComponentTypeID id = 0; id < MAX_COMPONENTS; ++id) {
+        if (m_sparse_pools[id] && !loaded.test(id))
+            m_sparse_pools[id]->clear();
+    }
+}
+
+auto World::record(EntityID entity) -> EntityRecord& {
+    if (!isAlive(entity))
+        throw std::out_of_range("entity " + std::to_string(entity) + " is not alive");
+    return m_records[entityIndex(entity)];
+}
+
+auto World::record(EntityID entity) const -> const EntityRecord& {
+    if (!isAlive(entity))
+        throw std::out_of_range("entity " + std::to_string(entity) + " is not alive");
+    return m_records[entityIndex(entity)];
+}
+
+auto World::archetypeFor(const Signature& signature) -> Archetype* {
+    auto it = m_archetype_map.find(signature);
+    if (it != m_archetype_map.end())
+        return it->second;
+
+    auto* ptr = m_arena.create<Archetype>(signature, m_chunk_allocator);
+    m_archetype_map.emplace(signature, ptr);
+    m_archetypes.push_back(ptr);
+    for (auto& query : m_queries)
+        query->offer(ptr);
+    return ptr;
+}
+
+auto World::query(const Signature& all, const Signature& none) -> Query& {
+    for (auto& query : m_queries) {
+        if (query->all() == all && query->none() == none)
+            return *query;
+    }
+
+    auto filter = all | none;
+    for (ComponentTypeID id = 0; id < MAX_COMPONENTS; ++id) {
+        if (filter.test(id) && ComponentRegistry::isRegistered(id) &&
+            ComponentRegistry::get(id).storage == StorageMode::Sparse)
+            throw std::invalid_argument(std::string("queries can't filter on sparse component ") +
+                                        ComponentRegistry::get(id).name);
+    }
+
+    auto& query = m_queries.emplace_back(std::make_unique<Query>(all, none, m_tick, &m_arena));
+    for (auto* archetype : m_archetypes)
+        query->offer(archetype);
+    return *query;
+}
+
+auto World::archetypeWith(Archetype* from, ComponentTypeID id) -> Archetype* {
+    auto*& edge = from->add_edges[id];
+    if (!edge)
+        edge = archetypeFor(Signature(from->signature()).set(id));
+    return edge;
+}
+
+auto World::archetypeWithout(Archetype* from, ComponentTypeID id) -> Archetype* {
+    auto*& edge = from->remove_edges[id];
+    if (!edge)
+        edge = archetypeFor(Signature(from->signature()).reset(id));
+    return edge;
+}
+
+void World::moveEntity(EntityID entity, EntityRecord& rec, Archetype* target) {
+    auto* source = rec.archetype;
+    auto& src_chunk = source->chunks()[rec.chunk];
+    auto [chunk_index, row] = target->pushRow(entity);
+    auto& dst_chunk = target->chunks()[chunk_index];
+
+    for (const auto& col : source->columns()) {
+        auto id = col.info->id;
+        auto* src = source->componentData(src_chunk, id, rec.row);
+        if (!target->hasColumn(id)) {
+            if (!col.info->trivial)
+                col.info->destroy(src);
+            continue;
+        }
+        auto* dst = target->componentData(dst_chunk, id, row);
+        if (col.info->trivial)
+            std::memcpy(dst, src, col.info->size);
+        else
+            col.info->relocate(dst, src);
+        target->stamp(dst_chunk, id, row, source->rowTick(src_chunk, id, rec.row));
+    }
+
+    auto moved = source->removeRow(rec.chunk, rec.row, false);
+    if (moved != INVALID_ENTITY) {
+        m_records[entityIndex(moved)].chunk = rec.chunk;
+        m_records[entityIndex(moved)].row = rec.row;
+    }
+    rec.archetype = target;
+    rec.chunk = chunk_index;
+    rec.row = row;
+}
+
+} // namespace game
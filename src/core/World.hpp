@@ -0,0 +1,396 @@
+#pragma once
+
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "core/Archetype.hpp"
+#include "core/Arena.hpp"
+#include "core/Entity.hpp"
+#include "core/Event.hpp"
+#include "core/Prefab.hpp"
+#include "core/Query.hpp"
+#include "core/Resource.hpp"
+#include "core/Snapshot.hpp"
+#include "core/SparsePool.hpp"
+
+namespace game {
+
+// where an entity's components live
+struct EntityRecord {
+    Archetype* archetype = nullptr;
+    uint32_t chunk = 0;
+    uint32_t row = 0;
+};
+
+// all of a World's storage (chunks, archetypes, query caches, sparse pools,
+// entity records) comes from its own arena, so a room can be torn down with
+// clear() without handing memory back piece by piece. event queues and
+// resources outlive clear(), systems keep references to them: they live in
+// a second arena that is never rewound.
+class World {
+public:
+    World();
+    World(const World&) = delete;
+    auto operator=(const World&) -> World& = delete;
+    ~World();
+
+    // destroys every entity and archetype and rewinds the arena, keeping its
+    // blocks for the next match. queries, event queues and resources stay
+    // valid: queues are emptied and resources reset to a default-constructed
+    // value. references returned by pool() don't.
+    void clear();
+    auto arena() -> Arena& { return m_arena; }
+
+    // raw state for SnapshotRing. load only accepts a snapshot of this World
+    // taken since the last clear(); archetypes created after it are emptied.
+    void saveSnapshot(SnapshotBuffer& out) const;
+    void loadSnapshot(SnapshotBuffer& in);
+
+    auto createEntity() -> EntityID;
+    void destroyEntity(EntityID entity);
+    // creates out.size() entities from the prefab with one archetype bulk
+    // insert and writes their handles to out. per-instance arrays, one value
+    // per entity, replace the prefab defaults of their columns:
+    //     world.instantiate(collider, handles, positions.data());
+    void instantiate(const Prefab& prefab, Span<EntityID> out) { instantiateRows(prefab, out, nullptr, 0); }
+    template <typename... Ts>
+    void instantiate(const Prefab& prefab, Span<EntityID> out, const Ts*... values);
+    auto isAlive(EntityID entity) const -> bool { return m_entities.isAlive(entity); }
+    auto entityCount() const -> std::size_t { return m_entities.aliveCount(); }
+
+    // delayed index reuse for networked rooms, see EntityAllocator. snapshots
+    // are sequenced by tick: an entity destroyed on tick t is missing from
+    // snapshot t on, and its index is reused once every client acknowledged
+    // a later one. a room without clients acknowledges its current tick.
+    void setEntityQuarantine(bool enabled) { m_entities.setQuarantine(enabled); }
+    void acknowledgeSnapshot(SequenceNumber oldest_ack) { m_entities.acknowledge(oldest_ack); }
+
+    // tick stamped on every component write, see changedSince()
+    void setTick(Tick tick) { m_tick = tick; }
+    auto tick() const -> Tick { return m_tick; }
+
+    // adds the component (or overwrites it if already present)
+    template <typename T>
+    auto add(EntityID entity, T component = {}) -> T&;
+    template <typename T>
+    void remove(EntityID entity);
+    template <typename T>
+    auto has(EntityID entity) const -> bool;
+    // mutable access counts as a write on the current tick
+    template <typename T>
+    auto get(EntityID entity) -> T&;
+    template <typename T>
+    auto tryGet(EntityID entity) -> T*;
+    // read-only access, doesn't touch change ticks
+    template <typename T>
+    auto read(EntityID entity) const -> const T&;
+    template <typename T>
+    auto tryRead(EntityID entity) const -> const T*;
+    // true if the component was added or written after tick `since`
+    template <typename T>
+    auto changedSince(EntityID entity, Tick since) const -> bool;
+
+    // archetype components plus the sparse components the entity has
+    auto signature(EntityID entity) const -> Signature;
+    // every archetype created so far, in creation order
+    auto archetypes() const -> const std::pmr::vector<Archetype*>& { return m_archetypes; }
+
+    // persistent query over archetype-stored components, created on first use and
+    // kept up to date as archetypes are created. the reference stays valid for
+    // the lifetime of the World, even across clear().
+    auto query(const Signature& all, const Signature& none = {}) -> Query&;
+    template <typename... Ts>
+    auto query() -> Query& { return query(signatureOf<Ts...>()); }
+
+    // pool backing a StorageMode::Sparse component, created on first use
+    template <typename T>
+    auto pool() -> SparsePool<T>&;
+
+    // room-wide singleton of type R, e.g. the level bounds. the reference
+    // stays valid until the resource is removed (setting it again assigns
+    // in place), so systems can keep it instead of looking it up every tick.
+    template <typename R>
+    auto setResource(R value) -> R&;
+    template <typename R>
+    void removeResource();
+    template <typename R>
+    auto hasResource() const -> bool { return m_resources[resourceId<R>()].data != nullptr; }
+    template <typename R>
+    auto resource() -> R&;
+    template <typename R>
+    auto resource() const -> const R&;
+    template <typename R>
+    auto tryResource() -> R* { return static_cast<R*>(m_resources[resourceId<R>()].data); }
+    template <typename R>
+    auto tryResource() const -> const R* { return static_cast<const R*>(m_resources[resourceId<R>()].data); }
+
+    // creates the event stream of type E if it doesn't exist yet. not
+    // thread-safe: SystemManager::add() registers the events a system
+    // declares with sends()/receives() before the first update.
+    template <typename E>
+    auto registerEvent(std::size_t capacity = EventQueue<E>::DEFAULT_CAPACITY) -> EventQueue<E>&;
+    // event stream of type E, throws std::out_of_range if it wasn't
+    // registered. a plain lookup, safe from any thread.
+    template <typename E>
+    auto events() -> EventQueue<E>&;
+    // end of tick: makes the events sent during the tick readable, see
+    // EventQueueBase::swap(). called by SystemManager::update().
+    void swapEvents();
+
+private:
+    struct InstanceColumn {
+        ComponentTypeID id;
+        const void* values;
+    };
+
+    void instantiateRows(const Prefab& prefab, Span<EntityID> out, const InstanceColumn* columns,
+                         std::size_t column_count);
+    auto record(EntityID entity) -> EntityRecord&;
+    auto record(EntityID entity) const -> const EntityRecord&;
+    auto archetypeFor(const Signature& signature) -> Archetype*;
+    auto archetypeWith(Archetype* from, ComponentTypeID id) -> Archetype*;
+    auto archetypeWithout(Archetype* from, ComponentTypeID id) -> Archetype*;
+    // moves the entity row to target: shared components are relocated, the
+    // ones missing from target are destroyed, new ones are left uninitialized
+    void moveEntity(EntityID entity, EntityRecord& rec, Archetype* target);
+    // runs the destructors of everything constructed in the arena
+    void destroyStorage();
+
+    // declared first so they outlive everything allocated from them
+    Arena m_arena;
+    // event queues and resources, kept across clear()
+    Arena m_persistent_arena{PERSISTENT_BLOCK_SIZE};
+    // archetypes release their chunks to it on destruction
+    ChunkAllocator m_chunk_allocator{&m_arena};
+    // archetypes and sparse pools are constructed in the arena
+    std::pmr::unordered_map<Signature, Archetype*> m_archetype_map{&m_arena};
+    std::pmr::vector<Archetype*> m_archetypes{&m_arena};
+    Archetype* m_root_archetype = nullptr;
+    // heap-allocated so systems can keep references across clear()
+    std::vector<std::unique_ptr<Query>> m_queries;
+    Tick m_tick = 0;
+    // bumped by clear(), invalidates older snapshots
+    uint64_t m_epoch = 0;
+
+    std::array<SparsePoolBase*, MAX_COMPONENTS> m_sparse_pools{};
+    std::array<EventQueueBase*, MAX_EVENT_TYPES> m_event_queues{};
+
+    struct ResourceSlot {
+        void* data = nullptr;
+        // arena memory of the resource, kept when it is removed so setting
+        // it again doesn't allocate: the arena never gets small blocks back
+        void* storage = nullptr;
+        void (*destroy)(void* data) = nullptr;
+        // back to a default-constructed value, on clear()
+        void (*reset)(void* data) = nullptr;
+    };
+    static constexpr std::size_t PERSISTENT_BLOCK_SIZE = 16 * 1024;
+    std::array<ResourceSlot, MAX_RESOURCES> m_resources{};
+
+    EntityAllocator m_entities{&m_arena};
+    // indexed by entityIndex()
+    std::pmr::vector<EntityRecord> m_records{&m_arena};
+};
+
+template <typename... Ts>
+void World::instantiate(const Prefab& prefab, Span<EntityID> out, const Ts*... values) {
+    if (!(prefab.has<Ts>() && ...))
+        throw std::invalid_argument("per-instance values for a component the prefab " + prefab.name() +
+                                    " doesn't have");
+    InstanceColumn columns[] = {{componentId<Ts>(), values}...};
+    instantiateRows(prefab, out, columns, sizeof...(Ts));
+}
+
+template <typename T>
+auto World::add(EntityID entity, T component) -> T& {
+    constexpr auto id = componentId<T>();
+    ComponentRegistry::registerComponent<T>();
+
+    auto& rec = record(entity);
+    if constexpr (isSparse<T>)
+        return pool<T>().emplace(entity, std::move(component), m_tick);
+
+    if (rec.archetype->hasColumn(id)) {
+        auto& chunk = rec.archetype->chunks()[rec.chunk];
+        auto* existing = static_cast<T*>(rec.archetype->componentData(chunk, id, rec.row));
+        *existing = std::move(component);
+        rec.archetype->stamp(chunk, id, rec.row, m_tick);
+        return *existing;
+    }
+
+    moveEntity(entity, rec, archetypeWith(rec.archetype, id));
+    auto& chunk = rec.archetype->chunks()[rec.chunk];
+    auto* added = new (rec.archetype->componentData(chunk, id, rec.row)) T(std::move(component));
+    rec.archetype->stamp(chunk, id, rec.row, m_tick);
+    return *added;
+}
+
+template <typename T>
+void World::remove(EntityID entity) {
+    constexpr auto id = componentId<T>();
+    auto& rec = record(entity);
+    if constexpr (isSparse<T>) {
+        if (m_sparse_pools[id])
+            m_sparse_pools[id]->remove(entity);
+    }
+    else if (rec.archetype->hasColumn(id))
+        moveEntity(entity, rec, archetypeWithout(rec.archetype, id));
+}
+
+template <typename T>
+auto World::has(EntityID entity) const -> bool {
+    constexpr auto id = componentId<T>();
+    auto& rec = record(entity);
+    if constexpr (isSparse<T>)
+        return m_sparse_pools[id] && m_sparse_pools[id]->contains(entity);
+    else
+        return rec.archetype->hasColumn(id);
+}
+
+template <typename T>
+auto World::get(EntityID entity) -> T& {
+    auto* component = tryGet<T>(entity);
+    if (!component)
+        throw std::out_of_range(std::string("entity has no ") + ComponentTraits<T>::name);
+    return *component;
+}
+
+template <typename T>
+auto World::tryGet(EntityID entity) -> T* {
+    constexpr auto id = componentId<T>();
+    if constexpr (isSparse<T>) {
+        record(entity);
+        auto* pool = static_cast<SparsePool<T>*>(m_sparse_pools[id]);
+        return pool ? pool->tryWrite(entity, m_tick) : nullptr;
+    }
+    else {
+        auto& rec = record(entity);
+        if (!rec.archetype->hasColumn(id))
+            return nullptr;
+        auto& chunk = rec.archetype->chunks()[rec.chunk];
+        rec.archetype->stamp(chunk, id, rec.row, m_tick);
+        return static_cast<T*>(rec.archetype->componentData(chunk, id, rec.row));
+    }
+}
+
+template <typename T>
+auto World::read(EntityID entity) const -> const T& {
+    auto* component = tryRead<T>(entity);
+    if (!component)
+        throw std::out_of_range(std::string("entity has no ") + ComponentTraits<T>::name);
+    return *component;
+}
+
+template <typename T>
+auto World::tryRead(EntityID entity) const -> const T* {
+    constexpr auto id = componentId<T>();
+    if constexpr (isSparse<T>) {
+        record(entity);
+        auto* pool = static_cast<SparsePool<T>*>(m_sparse_pools[id]);
+        return pool ? pool->tryGet(entity) : nullptr;
+    }
+    else {
+        auto& rec = record(entity);
+        if (!rec.archetype->hasColumn(id))
+            return nullptr;
+        auto& chunk = rec.archetype->chunks()[rec.chunk];
+        return static_cast<const T*>(rec.archetype->componentData(chunk, id, rec.row));
+    }
+}
+
+template <typename T>
+auto World::changedSince(EntityID entity, Tick since) const -> bool {
+    constexpr auto id = componentId<T>();
+    if constexpr (isSparse<T>) {
+        record(entity);
+        auto* pool = static_cast<SparsePool<T>*>(m_sparse_pools[id]);
+        auto* component = pool ? pool->tryGet(entity) : nullptr;
+        return component && pool->ticks()[component - pool->data()] > since;
+    }
+    else {
+        auto& rec = record(entity);
+        if (!rec.archetype->hasColumn(id))
+            return false;
+        auto& chunk = rec.archetype->chunks()[rec.chunk];
+        return rec.archetype->rowTick(chunk, id, rec.row) > since;
+    }
+}
+
+template <typename T>
+auto World::pool() -> SparsePool<T>& {
+    static_assert(isSparse<T>, "component is not sparse-stored");
+    constexpr auto id = componentId<T>();
+    if (!m_sparse_pools[id]) {
+        ComponentRegistry::registerComponent<T>();
+        m_sparse_pools[id] = m_arena.create<SparsePool<T>>(&m_arena);
+    }
+    return *static_cast<SparsePool<T>*>(m_sparse_pools[id]);
+}
+
+template <typename R>
+auto World::setResource(R value) -> R& {
+    static_assert(std::is_default_constructible_v<R>, "resources are reset to a default value by clear()");
+    auto& slot = m_resources[resourceId<R>()];
+    if (slot.data) {
+        auto& existing = *static_cast<R*>(slot.data);
+        existing = std::move(value);
+        return existing;
+    }
+    if (!slot.storage)
+        slot.storage = m_persistent_arena.allocate(sizeof(R), alignof(R));
+    auto* resource = new (slot.storage) R(std::move(value));
+    slot.data = resource;
+    slot.destroy = [](void* data) { static_cast<R*>(data)->~R(); };
+    slot.reset = [](void* data) { *static_cast<R*>(data) = R{}; };
+    return *resource;
+}
+
+template <typename R>
+void World::removeResource() {
+    auto& slot = m_resources[resourceId<R>()];
+    if (!slot.data)
+        return;
+    slot.destroy(slot.data);
+    slot.data = nullptr;
+}
+
+template <typename R>
+auto World::resource() -> R& {
+    auto* resource = tryResource<R>();
+    if (!resource)
+        throw std::out_of_range(std::string("world has no ") + ResourceTraits<R>::name);
+    return *resource;
+}
+
+template <typename R>
+auto World::resource() const -> const R& {
+    auto* resource = tryResource<R>();
+    if (!resource)
+        throw std::out_of_range(std::string("world has no ") + ResourceTraits<R>::name);
+    return *resource;
+}
+
+template <typename E>
+auto World::registerEvent(std::size_t capacity) -> EventQueue<E>& {
+    constexpr auto id = eventId<E>();
+    if (!m_event_queues[id])
+        m_event_queues[id] = m_persistent_arena.create<EventQueue<E>>(&m_persistent_arena, capacity);
+    return *static_cast<EventQueue<E>*>(m_event_queues[id]);
+}
+
+template <typename E>
+auto World::events() -> EventQueue<E>& {
+    auto* queue = m_event_queues[eventId<E>()];
+    if (!queue)
+        throw std::out_of_range(std::string("event ") + EventTraits<E>::name + " is not registered");
+    return *static_cast<EventQueue<E>*>(queue);
+}
+
+} // namespace game
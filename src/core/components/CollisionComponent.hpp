@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+
+#include "common/types.hpp"
+#include "core/Schema.hpp"
+
+namespace game::components {
+
+// AABB relative to the entity Position
+struct CollisionComponent {
+    float offset_x = 0.f;
+    float offset_y = 0.f;
+    float width = 0.f;
+    float height = 0.f;
+    bool is_static = false;
+};
+
+} // namespace game::components
+
+namespace game {
+
+template <>
+struct ComponentTraits<components::CollisionComponent> {
+    static constexpr ComponentTypeID id = ComponentType::CollisionComponent;
+    static constexpr const char* name = "CollisionComponent";
+    static constexpr auto fields = std::make_tuple(
+        field("offset_x", &components::CollisionComponent::offset_x, 16, -256.0, 256.0),
+        field("offset_y", &components::CollisionComponent::offset_y, 16, -256.0, 256.0),
+        field("width", &components::CollisionComponent::width, 16, 0.0, 512.0),
+        field("height", &components::CollisionComponent::height, 16, 0.0, 512.0),
+        field("is_static", &components::CollisionComponent::is_static, 1));
+};
+
+} // namespace game
@@ -0,0 +1,25 @@
+#pragma once
+
+// all components with a fixed ID in ComponentType (types.hpp)
+#include "core/components/PositionComponent.hpp"
+#include "core/components/VelocityComponent.hpp"
+#include "core/components/HealthComponent.hpp"
+#include "core/components/PlayerComponent.hpp"
+#include "core/components/TransformComponent.hpp"
+#include "core/components/InputComponent.hpp"
+#include "core/components/CollisionComponent.hpp"
+
+namespace game {
+
+// exchanged at handshake: a peer built with different component ids, fields
+// or quantization has a different hash and must be rejected
+constexpr uint64_t COMPONENT_SCHEMA_HASH =
+    combinedSchemaHash<components::Position, components::Velocity, components::Health,
+                       components::PlayerComponent, components::Transform, components::InputComponent,
+                       components::CollisionComponent>();
+
+constexpr auto schemaCompatible(uint64_t peer_hash) -> bool {
+    return peer_hash == COMPONENT_SCHEMA_HASH;
+}
+
+} // namespace game
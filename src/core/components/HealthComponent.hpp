@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+
+#include "common/types.hpp"
+#include "core/Schema.hpp"
+
+namespace game::components {
+
+struct Health {
+    int32_t current = 100;
+    int32_t max = 100;
+};
+
+} // namespace game::components
+
+namespace game {
+
+template <>
+struct ComponentTraits<components::Health> {
+    static constexpr ComponentTypeID id = ComponentType::Health;
+    static constexpr const char* name = "Health";
+    // current may drop below zero on the killing blow
+    static constexpr auto fields = std::make_tuple(
+        field("current", &components::Health::current, 16, -32768.0),
+        field("max", &components::Health::max, 16));
+};
+
+} // namespace game
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+
+#include "common/types.hpp"
+#include "core/Schema.hpp"
+
+namespace game::components {
+
+struct InputComponent {
+    // bit flags: UP, DOWN, LEFT, RIGHT
+    uint8_t buttons = 0;
+    SequenceNumber sequence = 0;
+
+    static constexpr uint8_t UP = 1 << 0;
+    static constexpr uint8_t DOWN = 1 << 1;
+    static constexpr uint8_t LEFT = 1 << 2;
+    static constexpr uint8_t RIGHT = 1 << 3;
+};
+
+} // namespace game::components
+
+namespace game {
+
+template <>
+struct ComponentTraits<components::InputComponent> {
+    static constexpr ComponentTypeID id = ComponentType::InputComponent;
+    static constexpr const char* name = "InputComponent";
+    // attached and detached as players connect and go idle
+    static constexpr StorageMode storage = StorageMode::Sparse;
+    static constexpr auto fields = std::make_tuple(
+        field("buttons", &components::InputComponent::buttons, 4),
+        field("sequence", &components::InputComponent::sequence));
+};
+
+} // namespace game
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+
+#include "common/types.hpp"
+#include "core/Schema.hpp"
+
+namespace game::components {
+
+struct PlayerComponent {
+    PlayerID player_id = INVALID_PLAYER;
+    // from the LDtk "color" field of the Player entity
+    uint8_t color_r = 255;
+    uint8_t color_g = 255;
+    uint8_t color_b = 255;
+};
+
+} // namespace game::components
+
+namespace game {
+
+template <>
+struct ComponentTraits<components::PlayerComponent> {
+    static constexpr ComponentTypeID id = ComponentType::PlayerComponent;
+    static constexpr const char* name = "PlayerComponent";
+    // identity and colors are set at spawn and only read by rendering and
+    // networking, keep them out of the chunks movement and collision stream
+    static constexpr StorageMode storage = StorageMode::Cold;
+    static constexpr auto fields = std::make_tuple(
+        field("player_id", &components::PlayerComponent::player_id),
+        field("color_r", &components::PlayerComponent::color_r),
+        field("color_g", &components::PlayerComponent::color_g),
+        field("color_b", &components::PlayerComponent::color_b));
+};
+
+} // namespace game
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+
+#include "common/types.hpp"
+#include "core/Schema.hpp"
+
+namespace game::components {
+
+struct Position {
+    float x = 0.f;
+    float y = 0.f;
+};
+
+} // namespace game::components
+
+namespace game {
+
+template <>
+struct ComponentTraits<components::Position> {
+    static constexpr ComponentTypeID id = ComponentType::Position;
+    static constexpr const char* name = "Position";
+    // world units, 1/1024 resolution over +-8192
+    static constexpr auto fields = std::make_tuple(
+        field("x", &components::Position::x, 24, -8192.0, 8192.0),
+        field("y", &components::Position::y, 24, -8192.0, 8192.0));
+};
+
+} // namespace game
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+
+#include "common/types.hpp"
+#include "core/Schema.hpp"
+
+namespace game::components {
+
+struct Transform {
+    float rotation = 0.f;
+    float scale_x = 1.f;
+    float scale_y = 1.f;
+};
+
+} // namespace game::components
+
+namespace game {
+
+template <>
+struct ComponentTraits<components::Transform> {
+    static constexpr ComponentTypeID id = ComponentType::Transform;
+    static constexpr const char* name = "Transform";
+    static constexpr auto fields = std::make_tuple(
+        field("rotation", &components::Transform::rotation, 16, -360.0, 360.0),
+        field("scale_x", &components::Transform::scale_x, 12, 0.0, 16.0),
+        field("scale_y", &components::Transform::scale_y, 12, 0.0, 16.0));
+};
+
+} // namespace game
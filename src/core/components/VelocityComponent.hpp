@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+
+#include "common/types.hpp"
+#include "core/Schema.hpp"
+
+namespace game::components {
+
+// units per second, integrated with FIXED_TIMESTEP
+struct Velocity {
+    float x = 0.f;
+    float y = 0.f;
+};
+
+} // namespace game::components
+
+namespace game {
+
+template <>
+struct ComponentTraits<components::Velocity> {
+    static constexpr ComponentTypeID id = ComponentType::Velocity;
+    static constexpr const char* name = "Velocity";
+    // units per second, 1/16 resolution
+    static constexpr auto fields = std::make_tuple(
+        field("x", &components::Velocity::x, 16, -2048.0, 2048.0),
+        field("y", &components::Velocity::y, 16, -2048.0, 2048.0));
+};
+
+} // namespace game
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+
+#include "common/types.hpp"
+#include "core/Event.hpp"
+
+namespace game::events {
+
+struct DamageEvent {
+    EntityID target = INVALID_ENTITY;
+    EntityID source = INVALID_ENTITY;
+    int32_t amount = 0;
+};
+
+struct DeathEvent {
+    EntityID entity = INVALID_ENTITY;
+    EntityID killer = INVALID_ENTITY;
+};
+
+struct PickupEvent {
+    EntityID entity = INVALID_ENTITY;
+    EntityID item = INVALID_ENTITY;
+};
+
+// sent once per overlapping pair, a < b
+struct CollisionEvent {
+    EntityID a = INVALID_ENTITY;
+    EntityID b = INVALID_ENTITY;
+};
+
+} // namespace game::events
+
+namespace game {
+
+template <>
+struct EventTraits<events::DamageEvent> {
+    static constexpr EventTypeID id = EventType::Damage;
+    static constexpr const char* name = "Damage";
+};
+
+template <>
+struct EventTraits<events::DeathEvent> {
+    static constexpr EventTypeID id = EventType::Death;
+    static constexpr const char* name = "Death";
+};
+
+template <>
+struct EventTraits<events::PickupEvent> {
+    static constexpr EventTypeID id = EventType::Pickup;
+    static constexpr const char* name = "Pickup";
+};
+
+template <>
+struct EventTraits<events::CollisionEvent> {
+    static constexpr EventTypeID id = EventType::Collision;
+    static constexpr const char* name = "Collision";
+};
+
+} // namespace game
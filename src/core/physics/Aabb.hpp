@@ -0,0 +1,47 @@
+#pragma once
+
+#include <algorithm>
+
+namespace game::physics {
+
+// axis-aligned box in world units, y down like the level. boxes touching
+// only along an edge don't overlap.
+struct Aabb {
+    float min_x = 0.f;
+    float min_y = 0.f;
+    float max_x = 0.f;
+    float max_y = 0.f;
+
+    static auto fromRect(float left, float top, float width, float height) -> Aabb {
+        return {left, top, left + width, top + height};
+    }
+
+    auto width() const -> float { return max_x - min_x; }
+    auto height() const -> float { return max_y - min_y; }
+    auto centerX() const -> float { return (min_x + max_x) * 0.5f; }
+    auto centerY() const -> float { return (min_y + max_y) * 0.5f; }
+    // surface heuristic cost of the box, in 2D its half perimeter
+    auto cost() const -> float { return width() + height(); }
+
+    auto overlaps(const Aabb& other) const -> bool {
+        return min_x < other.max_x && other.min_x < max_x && min_y < other.max_y && other.min_y < max_y;
+    }
+    auto contains(const Aabb& other) const -> bool {
+        return min_x <= other.min_x && min_y <= other.min_y && other.max_x <= max_x && other.max_y <= max_y;
+    }
+    auto expanded(float margin) const -> Aabb {
+        return {min_x - margin, min_y - margin, max_x + margin, max_y + margin};
+    }
+
+    auto operator==(const Aabb& other) const -> bool {
+        return min_x == other.min_x && min_y == other.min_y && max_x == other.max_x && max_y == other.max_y;
+    }
+    auto operator!=(const Aabb& other) const -> bool { return !(*this == other); }
+};
+
+inline auto merge(const Aabb& a, const Aabb& b) -> Aabb {
+    return {std::min(a.min_x, b.min_x), std::min(a.min_y, b.min_y), std::max(a.max_x, b.max_x),
+            std::max(a.max_y, b.max_y)};
+}
+
+} // namespace game::physics
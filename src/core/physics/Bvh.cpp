@@ -0,0 +1,248 @@
+#include "core/physics/Bvh.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+namespace game::physics {
+
+namespace {
+
+constexpr float INF = std::numeric_limits<float>::infinity();
+
+// precomputed ray, slab test against boxes
+struct Ray {
+    float origin_x, origin_y;
+    float inv_x, inv_y;
+    bool flat_x, flat_y;
+
+    // distance at which the ray enters the box, INF if it misses it before max_t
+    auto enter(const Aabb& box, float max_t) const -> float {
+        float t0 = 0.f;
+        float t1 = max_t;
+        if (flat_x) {
+            if (origin_x < box.min_x || origin_x > box.max_x)
+                return INF;
+        }
+        else {
+            auto a = (box.min_x - origin_x) * inv_x;
+            auto b = (box.max_x - origin_x) * inv_x;
+            t0 = std::max(t0, std::min(a, b));
+            t1 = std::min(t1, std::max(a, b));
+        }
+        if (flat_y) {
+            if (origin_y < box.min_y || origin_y > box.max_y)
+                return INF;
+        }
+        else {
+            auto a = (box.min_y - origin_y) * inv_y;
+            auto b = (box.max_y - origin_y) * inv_y;
+            t0 = std::max(t0, std::min(a, b));
+            t1 = std::min(t1, std::max(a, b));
+        }
+        return t0 <= t1 ? t0 : INF;
+    }
+};
+
+struct Bin {
+    Aabb box;
+    uint32_t count = 0;
+};
+
+} // namespace
+
+void Bvh::clear() {
+    m_nodes.clear();
+    m_boxes.clear();
+    m_users.clear();
+    m_depth = 0;
+}
+
+void Bvh::build(Span<const Aabb> boxes) {
+    clear();
+    if (boxes.empty())
+        return;
+    if (boxes.size() >= std::numeric_limits<uint32_t>::max())
+        throw std::length_error("too many boxes for a Bvh");
+
+    auto count = static_cast<uint32_t>(boxes.size());
+    // built over indices into the boxes, which are reordered at the end
+    m_boxes.assign(boxes.begin(), boxes.end());
+    m_users.resize(count);
+    std::iota(m_users.begin(), m_users.end(), 0u);
+    m_centers_x.resize(count);
+    m_centers_y.resize(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        m_centers_x[i] = boxes[i].centerX();
+        m_centers_y[i] = boxes[i].centerY();
+    }
+    m_nodes.reserve(2 * std::size_t(count) - 1);
+    buildNode(0, count, 1);
+
+    for (uint32_t i = 0; i < count; ++i)
+        m_boxes[i] = boxes[m_users[i]];
+}
+
+auto Bvh::buildNode(uint32_t first, uint32_t count, int depth) -> uint32_t {
+    m_depth = std::max(m_depth, depth);
+    auto index = static_cast<uint32_t>(m_nodes.size());
+    m_nodes.emplace_back();
+
+    auto* begin = m_users.data() + first;
+    auto* end = begin + count;
+    auto bounds = m_boxes[*begin];
+    Aabb centers{m_centers_x[*begin], m_centers_y[*begin], m_centers_x[*begin], m_centers_y[*begin]};
+    for (auto* it = begin + 1; it != end; ++it) {
+        bounds = merge(bounds, m_boxes[*it]);
+        centers = merge(centers, {m_centers_x[*it], m_centers_y[*it], m_centers_x[*it], m_centers_y[*it]});
+    }
+    m_nodes[index].box = bounds;
+
+    auto makeLeaf = [&] {
+        m_nodes[index].offset = first;
+        m_nodes[index].count = count;
+        return index;
+    };
+    if (count <= MIN_LEAF_SIZE)
+        return makeLeaf();
+
+    uint32_t* mid = nullptr;
+    if (depth < SAH_DEPTH) {
+        // binned SAH: try SAH_BINS - 1 planes per axis over the centroid bounds
+        auto best_cost = INF;
+        int best_axis = -1;
+        int best_plane = 0;
+        for (int axis = 0; axis < 2; ++axis) {
+            auto lo = axis == 0 ? centers.min_x : centers.min_y;
+            auto extent = axis == 0 ? centers.width() : centers.height();
+            if (!(extent > 0.f))
+                continue;
+            const auto& center = axis == 0 ? m_centers_x : m_centers_y;
+            auto scale = SAH_BINS / extent;
+
+            Bin bins[SAH_BINS];
+            for (auto* it = begin; it != end; ++it) {
+                auto b = std::min(static_cast<int>((center[*it] - lo) * scale), SAH_BINS - 1);
+                bins[b].box = bins[b].count ? merge(bins[b].box, m_boxes[*it]) : m_boxes[*it];
+                ++bins[b].count;
+            }
+
+            // right side costs swept from the end, then the left side from the start
+            float right_cost[SAH_BINS] = {};
+            Bin right;
+            for (int plane = SAH_BINS - 1; plane > 0; --plane) {
+                if (bins[plane].count)
+                    right.box = right.count ? merge(right.box, bins[plane].box) : bins[plane].box;
+                right.count += bins[plane].count;
+                right_cost[plane] = right.count ? right.count * right.box.cost() : INF;
+            }
+            Bin left;
+            for (int plane = 1; plane < SAH_BINS; ++plane) {
+                if (bins[plane - 1].count)
+                    left.box = left.count ? merge(left.box, bins[plane - 1].box) : bins[plane - 1].box;
+                left.count += bins[plane - 1].count;
+                if (left.count == 0 || left.count == count)
+                    continue;
+                auto cost = left.count * left.box.cost() + right_cost[plane];
+                if (cost < best_cost) {
+                    best_cost = cost;
+                    best_axis = axis;
+                    best_plane = plane;
+                }
+            }
+        }
+
+        // splitting has to beat testing every box of the node
+        if (count <= MAX_LEAF_SIZE && !(best_cost < count * bounds.cost()))
+            return makeLeaf();
+        if (best_axis >= 0) {
+            auto lo = best_axis == 0 ? centers.min_x : centers.min_y;
+            auto scale = SAH_BINS / (best_axis == 0 ? centers.width() : centers.height());
+            const auto& center = best_axis == 0 ? m_centers_x : m_centers_y;
+            mid = std::partition(begin, end, [&](uint32_t i) {
+                return std::min(static_cast<int>((center[i] - lo) * scale), SAH_BINS - 1) < best_plane;
+            });
+            if (mid == begin || mid == end)
+                mid = nullptr;
+        }
+    }
+    else if (count <= MAX_LEAF_SIZE) {
+        return makeLeaf();
+    }
+
+    if (!mid) {
+        // median split on the longer centroid axis, also when every centroid
+        // is the same point
+        const auto& center = centers.width() >= centers.height() ? m_centers_x : m_centers_y;
+        mid = begin + count / 2;
+        std::nth_element(begin, mid, end, [&](uint32_t a, uint32_t b) { return center[a] < center[b]; });
+    }
+
+    auto left_count = static_cast<uint32_t>(mid - begin);
+    buildNode(first, left_count, depth + 1);
+    auto right = buildNode(first + left_count, count - left_count, depth + 1);
+    m_nodes[index].offset = right;
+    m_nodes[index].count = 0;
+    return index;
+}
+
+auto Bvh::raycast(float origin_x, float origin_y, float dir_x, float dir_y, float max_t, RayHit& hit) const -> bool {
+    if (m_nodes.empty())
+        return false;
+    Ray ray{origin_x, origin_y, 1.f / dir_x, 1.f / dir_y, dir_x == 0.f, dir_y == 0.f};
+
+    auto best = max_t;
+    auto found = false;
+    uint32_t stack[MAX_DEPTH];
+    float stack_t[MAX_DEPTH];
+    int top = 0;
+    if (ray.enter(m_nodes[0].box, best) == INF)
+        return false;
+
+    uint32_t index = 0;
+    for (;;) {
+        const auto& node = m_nodes[index];
+        if (node.count > 0) {
+            for (auto i = node.offset; i < node.offset + node.count; ++i) {
+                auto t = ray.enter(m_boxes[i], best);
+                if (t != INF && (!found || t < best)) {
+                    best = t;
+                    hit = {m_users[i], t};
+                    found = true;
+                }
+            }
+        }
+        else {
+            // nearest child first, the other one waits with its entry distance
+            auto near = index + 1;
+            auto far = node.offset;
+            auto t_near = ray.enter(m_nodes[near].box, best);
+            auto t_far = ray.enter(m_nodes[far].box, best);
+            if (t_far < t_near) {
+                std::swap(near, far);
+                std::swap(t_near, t_far);
+            }
+            if (t_near != INF) {
+                if (t_far != INF) {
+                    stack[top] = far;
+                    stack_t[top++] = t_far;
+                }
+                index = near;
+                continue;
+            }
+        }
+
+        // skip what is now further than the best hit
+        for (;;) {
+            if (top == 0)
+                return found;
+            --top;
+            if (stack_t[top] <= best)
+                break;
+        }
+        index = stack[top];
+    }
+}
+
+} // namespace game::physics
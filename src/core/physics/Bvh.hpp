@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "core/Span.hpp"
+#include "core/physics/Aabb.hpp"
+
+namespace game::physics {
+
+// one node of a flattened Bvh. the left child of an interior node is the
+// node right after it, only the right one needs an index.
+struct alignas(32) BvhNode {
+    Aabb box;
+    // interior: index of the right child. leaf: index of its first box.
+    uint32_t offset = 0;
+    // boxes in a leaf, 0 for an interior node
+    uint32_t count = 0;
+};
+static_assert(sizeof(BvhNode) == 32, "two nodes per cache line");
+
+// bounding volume hierarchy over boxes that don't move, e.g. the level
+// colliders. built top-down with the binned surface area heuristic into one
+// contiguous node array in depth-first order, the boxes reordered to match
+// the leaves. queries walk it with a small fixed stack, no recursion, and
+// may run on several threads at once. rebuilding means building again.
+class Bvh {
+public:
+    // boxes per leaf below which a node is never split
+    static constexpr uint32_t MIN_LEAF_SIZE = 2;
+    // boxes per leaf above which a node is always split
+    static constexpr uint32_t MAX_LEAF_SIZE = 8;
+    static constexpr int SAH_BINS = 16;
+    // below this depth nodes split on the SAH, deeper ones at the median, so
+    // the depth (and the traversal stack) stays under MAX_DEPTH
+    static constexpr int SAH_DEPTH = 32;
+    static constexpr int MAX_DEPTH = 64;
+
+    struct RayHit {
+        uint32_t user = 0;
+        // distance along the ray, in units of its direction
+        float t = 0.f;
+    };
+
+    // boxes[i] gets user value i
+    void build(Span<const Aabb> boxes);
+    void clear();
+
+    // calls fn(user) once for every box overlapping the query box
+    template <typename Fn>
+    void query(const Aabb& box, Fn&& fn) const;
+    // nearest box hit by origin + t * direction for t in [0, max_t]
+    auto raycast(float origin_x, float origin_y, float dir_x, float dir_y, float max_t, RayHit& hit) const -> bool;
+
+    auto nodes() const -> const std::vector<BvhNode>& { return m_nodes; }
+    auto size() const -> std::size_t { return m_boxes.size(); }
+    auto empty() const -> bool { return m_boxes.empty(); }
+    auto depth() const -> int { return m_depth; }
+
+private:
+    auto buildNode(uint32_t first, uint32_t count, int depth) -> uint32_t;
+
+    std::vector<BvhNode> m_nodes;
+    // in leaf order
+    std::vector<Aabb> m_boxes;
+    std::vector<uint32_t> m_users;
+    int m_depth = 0;
+
+    // build scratch
+    std::vector<float> m_centers_x;
+    std::vector<float> m_centers_y;
+};
+
+template <typename Fn>
+void Bvh::query(const Aabb& box, Fn&& fn) const {
+    if (m_nodes.empty() || !m_nodes[0].box.overlaps(box))
+        return;
+    uint32_t stack[MAX_DEPTH];
+    int top = 0;
+    uint32_t index = 0;
+    for (;;) {
+        const auto& node = m_nodes[index];
+        if (node.count > 0) {
+            for (auto i = node.offset; i < node.offset + node.count; ++i) {
+                if (m_boxes[i].overlaps(box))
+                    fn(m_users[i]);
+            }
+        }
+        else {
+            // children are tested before being visited, so only overlapping
+            // ones ever reach the stack
+            auto left = index + 1;
+            auto right = node.offset;
+            auto hit_left = m_nodes[left].box.overlaps(box);
+            auto hit_right = m_nodes[right].box.overlaps(box);
+            if (hit_left && hit_right) {
+                stack[top++] = right;
+                index = left;
+                continue;
+            }
+            if (hit_left || hit_right) {
+                index = hit_left ? left : right;
+                continue;
+            }
+        }
+        if (top == 0)
+            return;
+        index = stack[--top];
+    }
+}
+
+} // namespace game::physics
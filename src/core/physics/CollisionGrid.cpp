@@ -0,0 +1,114 @@
+#include "core/physics/CollisionGrid.hpp"
+
+#include <algorithm>
+#include <bitset>
+#include <cmath>
+#include <stdexcept>
+
+namespace game::physics {
+
+CollisionGrid::CollisionGrid(int width, int height, float cell_size, float origin_x, float origin_y)
+: m_width(width), m_height(height), m_cell_size(cell_size), m_origin_x(origin_x), m_origin_y(origin_y) {
+    if (width < 0 || height < 0)
+        throw std::invalid_argument("collision grid size must not be negative");
+    if (!(cell_size > 0.f))
+        throw std::invalid_argument("collision grid cell size must be positive");
+    m_stride = (std::size_t(width) + 63) / 64;
+    m_bits.assign(m_stride * std::size_t(height), 0);
+}
+
+void CollisionGrid::set(int x, int y, bool solid) {
+    if (x < 0 || y < 0 || x >= m_width || y >= m_height)
+        throw std::out_of_range("cell outside the collision grid");
+    auto& word = m_bits[std::size_t(y) * m_stride + (x >> 6)];
+    auto bit = uint64_t(1) << (x & 63);
+    word = solid ? word | bit : word & ~bit;
+}
+
+auto CollisionGrid::solidAt(float x, float y) const -> bool {
+    auto cx = std::floor((x - m_origin_x) / m_cell_size);
+    auto cy = std::floor((y - m_origin_y) / m_cell_size);
+    if (cx < 0.f || cy < 0.f || cx >= float(m_width) || cy >= float(m_height))
+        return false;
+    return solid(static_cast<int>(cx), static_cast<int>(cy));
+}
+
+auto CollisionGrid::overlaps(const Aabb& box) const -> bool {
+    auto cells = cellsOf(box);
+    if (cells.empty())
+        return false;
+    for (auto y = cells.y0; y <= cells.y1; ++y) {
+        const auto* bits = row(y);
+        for (auto word = cells.x0 >> 6; word <= cells.x1 >> 6; ++word) {
+            if (bits[word] & wordMask(word, cells.x0, cells.x1))
+                return true;
+        }
+    }
+    return false;
+}
+
+auto CollisionGrid::solidCount() const -> std::size_t {
+    std::size_t count = 0;
+    for (auto word : m_bits)
+        count += std::bitset<64>(word).count();
+    return count;
+}
+
+auto CollisionGrid::solidRects() const -> std::vector<Aabb> {
+    std::vector<Aabb> rects;
+    // cells are cleared from a copy as rectangles take them
+    auto bits = m_bits;
+    auto rowOf = [&](int y) { return bits.data() + std::size_t(y) * m_stride; };
+    auto full = [&](int y, int x0, int x1) {
+        const auto* cells = rowOf(y);
+        for (auto word = x0 >> 6; word <= x1 >> 6; ++word) {
+            auto mask = wordMask(word, x0, x1);
+            if ((cells[word] & mask) != mask)
+                return false;
+        }
+        return true;
+    };
+
+    for (auto y = 0; y < m_height; ++y) {
+        auto* cells = rowOf(y);
+        for (std::size_t word = 0; word < m_stride; ++word) {
+            while (cells[word]) {
+                auto x0 = static_cast<int>(word * 64 + lowestBit(cells[word]));
+                // the run ends before the first empty cell after x0, padding
+                // bits are empty so it stops at the grid edge
+                auto end = word;
+                auto empty = ~cells[end] & (~uint64_t(0) << (x0 & 63));
+                while (!empty && ++end < m_stride)
+                    empty = ~cells[end];
+                auto x1 = end < m_stride ? static_cast<int>(end * 64 + lowestBit(empty)) - 1 : m_width - 1;
+
+                auto y1 = y;
+                while (y1 + 1 < m_height && full(y1 + 1, x0, x1))
+                    ++y1;
+                for (auto taken = y; taken <= y1; ++taken) {
+                    auto* row_bits = rowOf(taken);
+                    for (auto w = x0 >> 6; w <= x1 >> 6; ++w)
+                        row_bits[w] &= ~wordMask(w, x0, x1);
+                }
+                rects.push_back(Aabb::fromRect(m_origin_x + x0 * m_cell_size, m_origin_y + y * m_cell_size,
+                                               (x1 - x0 + 1) * m_cell_size, (y1 - y + 1) * m_cell_size));
+            }
+        }
+    }
+    return rects;
+}
+
+auto CollisionGrid::cellsOf(const Aabb& box) const -> CellRange {
+    // a cell overlaps the box when it starts before max and ends after min
+    auto x0 = std::floor((box.min_x - m_origin_x) / m_cell_size);
+    auto y0 = std::floor((box.min_y - m_origin_y) / m_cell_size);
+    auto x1 = std::ceil((box.max_x - m_origin_x) / m_cell_size) - 1.f;
+    auto y1 = std::ceil((box.max_y - m_origin_y) / m_cell_size) - 1.f;
+    // clamped as floats first, far away boxes would overflow an int
+    auto clampX = [&](float v) { return static_cast<int>(std::clamp(v, -1.f, float(m_width))); };
+    auto clampY = [&](float v) { return static_cast<int>(std::clamp(v, -1.f, float(m_height))); };
+    return {std::max(clampX(x0), 0), std::max(clampY(y0), 0), std::min(clampX(x1), m_width - 1),
+            std::min(clampY(y1), m_height - 1)};
+}
+
+} // namespace game::physics
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "core/Bits.hpp"
+#include "core/physics/Aabb.hpp"
+
+namespace game::physics {
+
+// solid tiles of a level as a packed bitset, one bit per cell, rows padded
+// to whole 64-bit words (stride() words per row). testing a cell is a shift
+// and a mask; a box is tested against the grid by scanning only the rows
+// and words it covers, 64 cells at a time.
+class CollisionGrid {
+public:
+    CollisionGrid() = default;
+    // width x height cells of cell_size, the top-left one at (origin_x, origin_y)
+    CollisionGrid(int width, int height, float cell_size, float origin_x = 0.f, float origin_y = 0.f);
+
+    void set(int x, int y, bool solid = true);
+    // cells outside the grid are not solid
+    auto solid(int x, int y) const -> bool {
+        if (x < 0 || y < 0 || x >= m_width || y >= m_height)
+            return false;
+        return (m_bits[std::size_t(y) * m_stride + (x >> 6)] >> (x & 63)) & 1;
+    }
+    auto solidAt(float x, float y) const -> bool;
+
+    // true if a solid cell overlaps the box
+    auto overlaps(const Aabb& box) const -> bool;
+    // calls fn(x, y) for every solid cell overlapping the box, row by row
+    template <typename Fn>
+    void forEachSolid(const Aabb& box, Fn&& fn) const;
+
+    auto cellBox(int x, int y) const -> Aabb {
+        return Aabb::fromRect(m_origin_x + x * m_cell_size, m_origin_y + y * m_cell_size, m_cell_size, m_cell_size);
+    }
+    auto width() const -> int { return m_width; }
+    auto height() const -> int { return m_height; }
+    auto cellSize() const -> float { return m_cell_size; }
+    auto stride() const -> std::size_t { return m_stride; }
+    auto row(int y) const -> const uint64_t* { return m_bits.data() + std::size_t(y) * m_stride; }
+    auto solidCount() const -> std::size_t;
+    // the solid cells merged into few rectangles to be used as colliders:
+    // each row's runs of solid cells are taken left to right and grown down
+    // while the rows below are solid across the whole run. greedy, so not
+    // always the minimum, but close to it for level shapes.
+    auto solidRects() const -> std::vector<Aabb>;
+
+private:
+    struct CellRange {
+        int x0, y0, x1, y1;
+        auto empty() const -> bool { return x0 > x1 || y0 > y1; }
+    };
+
+    // cells the box overlaps, clamped to the grid
+    auto cellsOf(const Aabb& box) const -> CellRange;
+    // bits x0..x1 of the word holding cell `word * 64`
+    static auto wordMask(int word, int x0, int x1) -> uint64_t {
+        auto lo = word * 64 > x0 ? 0 : x0 & 63;
+        auto hi = word * 64 + 63 < x1 ? 63 : x1 & 63;
+        auto upper = hi == 63 ? ~uint64_t(0) : (uint64_t(1) << (hi + 1)) - 1;
+        return upper & (~uint64_t(0) << lo);
+    }
+
+    int m_width = 0;
+    int m_height = 0;
+    float m_cell_size = 1.f;
+    float m_origin_x = 0.f;
+    float m_origin_y = 0.f;
+    std::size_t m_stride = 0;
+    std::vector<uint64_t> m_bits;
+};
+
+template <typename Fn>
+void CollisionGrid::forEachSolid(const Aabb& box, Fn&& fn) const {
+    auto cells = cellsOf(box);
+    if (cells.empty())
+        return;
+    for (auto y = cells.y0; y <= cells.y1; ++y) {
+        const auto* bits = row(y);
+        for (auto word = cells.x0 >> 6; word <= cells.x1 >> 6; ++word) {
+            auto solid = bits[word] & wordMask(word, cells.x0, cells.x1);
+            while (solid) {
+                fn(word * 64 + static_cast<int>(lowestBit(solid)), y);
+                solid &= solid - 1;
+            }
+        }
+    }
+}
+
+} // namespace game::physics
@@ -0,0 +1,199 @@
+#include "core/physics/DynamicTree.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace game::physics {
+
+auto DynamicTree::insert(const Aabb& box, uint32_t user) -> ProxyID {
+    auto leaf = allocateNode();
+    auto& node = m_nodes[leaf];
+    node.tight = box;
+    node.box = box.expanded(m_margin);
+    node.user = user;
+    node.height = 0;
+    insertLeaf(leaf);
+    ++m_size;
+    return leaf;
+}
+
+void DynamicTree::remove(ProxyID proxy) {
+    if (proxy >= m_nodes.size() || m_nodes[proxy].height != 0)
+        throw std::out_of_range("dynamic tree proxy is not a leaf");
+    removeLeaf(proxy);
+    freeNode(proxy);
+    --m_size;
+}
+
+auto DynamicTree::move(ProxyID proxy, const Aabb& box) -> bool {
+    if (proxy >= m_nodes.size() || m_nodes[proxy].height != 0)
+        throw std::out_of_range("dynamic tree proxy is not a leaf");
+    auto& node = m_nodes[proxy];
+    if (node.tight == box)
+        return false;
+    node.tight = box;
+    if (node.box.contains(box))
+        return false;
+
+    removeLeaf(proxy);
+    m_nodes[proxy].box = box.expanded(m_margin);
+    insertLeaf(proxy);
+    return true;
+}
+
+void DynamicTree::clear() {
+    m_nodes.clear();
+    m_root = NIL;
+    m_free = NIL;
+    m_size = 0;
+}
+
+auto DynamicTree::allocateNode() -> uint32_t {
+    if (m_free == NIL) {
+        m_nodes.emplace_back();
+        return static_cast<uint32_t>(m_nodes.size() - 1);
+    }
+    auto index = m_free;
+    m_free = m_nodes[index].parent;
+    m_nodes[index] = Node{};
+    return index;
+}
+
+void DynamicTree::freeNode(uint32_t index) {
+    auto& node = m_nodes[index];
+    node.height = -1;
+    node.left = node.right = NIL;
+    node.parent = m_free;
+    m_free = index;
+}
+
+void DynamicTree::insertLeaf(uint32_t leaf) {
+    if (m_root == NIL) {
+        m_root = leaf;
+        m_nodes[leaf].parent = NIL;
+        return;
+    }
+
+    // walk down to the cheapest sibling: the cost of a node is the area the
+    // new parent would add, plus what every ancestor grows by
+    auto box = m_nodes[leaf].box;
+    auto index = m_root;
+    while (!m_nodes[index].leaf()) {
+        const auto& node = m_nodes[index];
+        auto combined = merge(node.box, box).cost();
+        // pairing with this node itself
+        auto cost = 2.f * combined;
+        // pushing the leaf further down grows this node anyway
+        auto inherited = 2.f * (combined - node.box.cost());
+
+        auto descend = [&](uint32_t child) {
+            const auto& c = m_nodes[child];
+            auto grown = merge(c.box, box).cost();
+            return (c.leaf() ? grown : grown - c.box.cost()) + inherited;
+        };
+        auto cost_left = descend(node.left);
+        auto cost_right = descend(node.right);
+        if (cost < cost_left && cost < cost_right)
+            break;
+        index = cost_left < cost_right ? node.left : node.right;
+    }
+
+    auto sibling = index;
+    auto old_parent = m_nodes[sibling].parent;
+    auto parent = allocateNode();
+    auto& p = m_nodes[parent];
+    p.parent = old_parent;
+    p.box = merge(m_nodes[sibling].box, box);
+    p.height = m_nodes[sibling].height + 1;
+    p.left = sibling;
+    p.right = leaf;
+    m_nodes[sibling].parent = parent;
+    m_nodes[leaf].parent = parent;
+
+    if (old_parent == NIL) {
+        m_root = parent;
+    }
+    else {
+        auto& op = m_nodes[old_parent];
+        (op.left == sibling ? op.left : op.right) = parent;
+    }
+    fixUpwards(parent);
+}
+
+void DynamicTree::removeLeaf(uint32_t leaf) {
+    if (leaf == m_root) {
+        m_root = NIL;
+        return;
+    }
+
+    auto parent = m_nodes[leaf].parent;
+    auto grandparent = m_nodes[parent].parent;
+    auto sibling = m_nodes[parent].left == leaf ? m_nodes[parent].right : m_nodes[parent].left;
+    freeNode(parent);
+
+    m_nodes[sibling].parent = grandparent;
+    if (grandparent == NIL) {
+        m_root = sibling;
+        return;
+    }
+    auto& gp = m_nodes[grandparent];
+    (gp.left == parent ? gp.left : gp.right) = sibling;
+    fixUpwards(grandparent);
+}
+
+void DynamicTree::fixUpwards(uint32_t index) {
+    while (index != NIL) {
+        index = balance(index);
+        auto& node = m_nodes[index];
+        const auto& left = m_nodes[node.left];
+        const auto& right = m_nodes[node.right];
+        node.height = 1 + std::max(left.height, right.height);
+        node.box = merge(left.box, right.box);
+        index = node.parent;
+    }
+}
+
+auto DynamicTree::balance(uint32_t a) -> uint32_t {
+    auto& node_a = m_nodes[a];
+    if (node_a.leaf() || node_a.height < 2)
+        return a;
+
+    auto b = node_a.left;
+    auto c = node_a.right;
+    auto skew = m_nodes[c].height - m_nodes[b].height;
+    if (skew >= -1 && skew <= 1)
+        return a;
+
+    // the taller child (up) takes a's place; a keeps the shorter child and
+    // the shorter of up's children, up keeps its taller one
+    auto up = skew > 1 ? c : b;
+    auto& node_up = m_nodes[up];
+    auto f = node_up.left;
+    auto g = node_up.right;
+    auto taller = m_nodes[f].height > m_nodes[g].height ? f : g;
+    auto shorter = taller == f ? g : f;
+
+    node_up.left = a;
+    node_up.parent = node_a.parent;
+    node_a.parent = up;
+    if (node_up.parent == NIL) {
+        m_root = up;
+    }
+    else {
+        auto& parent = m_nodes[node_up.parent];
+        (parent.left == a ? parent.left : parent.right) = up;
+    }
+
+    node_up.right = taller;
+    (skew > 1 ? node_a.right : node_a.left) = shorter;
+    m_nodes[shorter].parent = a;
+
+    const auto& kept = m_nodes[skew > 1 ? b : c];
+    node_a.box = merge(kept.box, m_nodes[shorter].box);
+    node_a.height = 1 + std::max(kept.height, m_nodes[shorter].height);
+    node_up.box = merge(node_a.box, m_nodes[taller].box);
+    node_up.height = 1 + std::max(node_a.height, m_nodes[taller].height);
+    return up;
+}
+
+} // namespace game::physics
@@ -0,0 +1,171 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "core/physics/Aabb.hpp"
+#include "core/physics/SpatialHash.hpp"
+
+namespace game::physics {
+
+// incremental AABB tree for boxes that move every tick (players,
+// projectiles). each leaf stores a "fat" box, the real one grown by a
+// margin: small moves stay inside it and cost nothing, only a box leaving
+// its fat bounds is taken out and reinserted. inserts pick the sibling
+// with the surface area heuristic and the path back to the root is
+// rebalanced with tree rotations, so queries stay logarithmic.
+// queries are const and may run on several threads at once.
+class DynamicTree {
+public:
+    explicit DynamicTree(float margin = 2.f) : m_margin(margin) {}
+
+    auto insert(const Aabb& box, uint32_t user) -> ProxyID;
+    void remove(ProxyID proxy);
+    // returns true if the leaf had to be reinserted
+    auto move(ProxyID proxy, const Aabb& box) -> bool;
+    void clear();
+
+    // calls fn(user) once for every box overlapping the query box
+    template <typename Fn>
+    void query(const Aabb& box, Fn&& fn) const;
+    // calls fn(user_a, user_b) once for every pair of overlapping boxes, in
+    // either order
+    template <typename Fn>
+    void forEachPair(Fn&& fn) const;
+
+    auto box(ProxyID proxy) const -> const Aabb& { return m_nodes[proxy].tight; }
+    auto fatBox(ProxyID proxy) const -> const Aabb& { return m_nodes[proxy].box; }
+    auto user(ProxyID proxy) const -> uint32_t { return m_nodes[proxy].user; }
+    auto size() const -> std::size_t { return m_size; }
+    // 0 for a single leaf, -1 when empty
+    auto height() const -> int { return m_root == NIL ? -1 : m_nodes[m_root].height; }
+    auto margin() const -> float { return m_margin; }
+
+private:
+    static constexpr uint32_t NIL = INVALID_PROXY;
+
+    struct Node {
+        // fat box for leaves, union of the children for interior nodes
+        Aabb box;
+        Aabb tight;
+        // the next free node while the node is free
+        uint32_t parent = NIL;
+        uint32_t left = NIL;
+        uint32_t right = NIL;
+        // leaves are 0, free nodes -1
+        int32_t height = -1;
+        uint32_t user = 0;
+
+        auto leaf() const -> bool { return left == NIL; }
+    };
+
+    // explicit traversal stack, on the call stack unless the tree is very deep
+    class Stack {
+    public:
+        void push(uint32_t index) {
+            if (m_size < INLINE)
+                m_inline[m_size] = index;
+            else
+                m_overflow.push_back(index);
+            ++m_size;
+        }
+        auto pop() -> uint32_t {
+            --m_size;
+            if (m_size < INLINE)
+                return m_inline[m_size];
+            auto index = m_overflow.back();
+            m_overflow.pop_back();
+            return index;
+        }
+        auto empty() const -> bool { return m_size == 0; }
+
+    private:
+        static constexpr std::size_t INLINE = 64;
+        uint32_t m_inline[INLINE];
+        std::vector<uint32_t> m_overflow;
+        std::size_t m_size = 0;
+    };
+
+    auto allocateNode() -> uint32_t;
+    void freeNode(uint32_t index);
+    void insertLeaf(uint32_t leaf);
+    void removeLeaf(uint32_t leaf);
+    // refits the nodes from index up to the root, rotating unbalanced ones
+    void fixUpwards(uint32_t index);
+    // rotates a grandchild up if the subtree heights differ by more than
+    // one, returns the node now at that place
+    auto balance(uint32_t index) -> uint32_t;
+
+    float m_margin;
+    std::vector<Node> m_nodes;
+    uint32_t m_root = NIL;
+    uint32_t m_free = NIL;
+    std::size_t m_size = 0;
+};
+
+template <typename Fn>
+void DynamicTree::query(const Aabb& box, Fn&& fn) const {
+    if (m_root == NIL)
+        return;
+    Stack stack;
+    stack.push(m_root);
+    while (!stack.empty()) {
+        const auto& node = m_nodes[stack.pop()];
+        if (!node.box.overlaps(box))
+            continue;
+        if (node.leaf()) {
+            if (node.tight.overlaps(box))
+                fn(node.user);
+        }
+        else {
+            stack.push(node.left);
+            stack.push(node.right);
+        }
+    }
+}
+
+template <typename Fn>
+void DynamicTree::forEachPair(Fn&& fn) const {
+    // one walk of the tree against itself over pairs of nodes: (a, a) stands
+    // for the pairs inside a, two different nodes are only opened if their
+    // boxes overlap, so subtrees far apart are never visited
+    if (m_root == NIL)
+        return;
+    Stack stack;
+    auto push = [&](uint32_t a, uint32_t b) {
+        stack.push(a);
+        stack.push(b);
+    };
+    push(m_root, m_root);
+    while (!stack.empty()) {
+        auto b = stack.pop();
+        auto a = stack.pop();
+        const auto& node_a = m_nodes[a];
+        if (node_a.leaf() && a == b)
+            continue;
+        if (a == b) {
+            push(node_a.left, node_a.left);
+            push(node_a.right, node_a.right);
+            push(node_a.left, node_a.right);
+            continue;
+        }
+        const auto& node_b = m_nodes[b];
+        if (!node_a.box.overlaps(node_b.box))
+            continue;
+        if (node_a.leaf() && node_b.leaf()) {
+            if (node_a.tight.overlaps(node_b.tight))
+                fn(node_a.user, node_b.user);
+        }
+        else if (node_b.leaf() || (!node_a.leaf() && node_a.box.cost() >= node_b.box.cost())) {
+            // open the bigger node
+            push(node_a.left, b);
+            push(node_a.right, b);
+        }
+        else {
+            push(a, node_b.left);
+            push(a, node_b.right);
+        }
+    }
+}
+
+} // namespace game::physics
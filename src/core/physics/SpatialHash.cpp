@@ -0,0 +1,119 @@
+#include "core/physics/SpatialHash.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace game::physics {
+
+namespace {
+
+// keeps cell coordinates of far away boxes inside int32_t
+constexpr float MAX_CELL = 1 << 30;
+
+auto cellCoord(float value) -> int32_t {
+    return static_cast<int32_t>(std::clamp(std::floor(value), -MAX_CELL, MAX_CELL));
+}
+
+} // namespace
+
+SpatialHash::SpatialHash(float cell_size, std::size_t bucket_count)
+: m_cell_size(cell_size), m_inv_cell_size(1.f / cell_size) {
+    if (!(cell_size > 0.f))
+        throw std::invalid_argument("spatial hash cell size must be positive");
+    std::size_t buckets = 1;
+    while (buckets < bucket_count)
+        buckets <<= 1;
+    m_bucket_mask = buckets - 1;
+    m_buckets.resize(buckets);
+}
+
+auto SpatialHash::insert(const Aabb& box, uint32_t user) -> ProxyID {
+    ProxyID proxy;
+    if (!m_free.empty()) {
+        proxy = m_free.back();
+        m_free.pop_back();
+    }
+    else {
+        proxy = static_cast<ProxyID>(m_proxies.size());
+        m_proxies.emplace_back();
+    }
+
+    m_proxies[proxy] = {box, cellsOf(box), user, true};
+    link(proxy);
+    ++m_size;
+    return proxy;
+}
+
+void SpatialHash::remove(ProxyID proxy) {
+    if (proxy >= m_proxies.size() || !m_proxies[proxy].alive)
+        throw std::out_of_range("spatial hash proxy is not alive");
+    unlink(proxy);
+    m_proxies[proxy].alive = false;
+    m_free.push_back(proxy);
+    --m_size;
+}
+
+void SpatialHash::update(ProxyID proxy, const Aabb& box) {
+    if (proxy >= m_proxies.size() || !m_proxies[proxy].alive)
+        throw std::out_of_range("spatial hash proxy is not alive");
+    auto& p = m_proxies[proxy];
+    p.box = box;
+    auto cells = cellsOf(box);
+    if (cells == p.cells)
+        return;
+    unlink(proxy);
+    p.cells = cells;
+    link(proxy);
+}
+
+void SpatialHash::rebuild(Span<const Aabb> boxes) {
+    clear();
+    m_proxies.resize(boxes.size());
+    for (std::size_t i = 0; i < boxes.size(); ++i) {
+        auto proxy = static_cast<ProxyID>(i);
+        m_proxies[i] = {boxes[i], cellsOf(boxes[i]), proxy, true};
+        link(proxy);
+    }
+    m_size = boxes.size();
+}
+
+void SpatialHash::clear() {
+    // keep the bucket storage for the next rebuild
+    for (auto& bucket : m_buckets)
+        bucket.clear();
+    m_proxies.clear();
+    m_free.clear();
+    m_size = 0;
+}
+
+auto SpatialHash::cellsOf(const Aabb& box) const -> CellRange {
+    return {cellCoord(box.min_x * m_inv_cell_size), cellCoord(box.min_y * m_inv_cell_size),
+            cellCoord(box.max_x * m_inv_cell_size), cellCoord(box.max_y * m_inv_cell_size)};
+}
+
+void SpatialHash::link(ProxyID proxy) {
+    const auto& cells = m_proxies[proxy].cells;
+    for (auto y = cells.y0; y <= cells.y1; ++y) {
+        for (auto x = cells.x0; x <= cells.x1; ++x)
+            m_buckets[bucketOf(x, y)].push_back({x, y, proxy});
+    }
+}
+
+void SpatialHash::unlink(ProxyID proxy) {
+    const auto& cells = m_proxies[proxy].cells;
+    for (auto y = cells.y0; y <= cells.y1; ++y) {
+        for (auto x = cells.x0; x <= cells.x1; ++x) {
+            auto& bucket = m_buckets[bucketOf(x, y)];
+            for (std::size_t i = 0; i < bucket.size(); ++i) {
+                if (bucket[i].proxy == proxy && bucket[i].x == x && bucket[i].y == y) {
+                    bucket[i] = bucket.back();
+                    bucket.pop_back();
+                    break;
+                }
+            }
+        }
+    }
+}
+
+} // namespace game::physics
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "core/Span.hpp"
+#include "core/physics/Aabb.hpp"
+
+namespace game::physics {
+
+using ProxyID = uint32_t;
+constexpr ProxyID INVALID_PROXY = std::numeric_limits<ProxyID>::max();
+
+// uniform grid broadphase: the plane is cut into square cells (sized to the
+// level's grid, e.g. 16 px), and every cell a box covers is hashed into a
+// fixed array of buckets. a query only looks at the buckets of the cells it
+// covers, so its cost follows the local density instead of the box count.
+// boxes carry a user value (a collider index, an EntityID...) handed back
+// by query(). queries are const and may run on several threads at once.
+class SpatialHash {
+public:
+    // bucket_count is rounded up to a power of two
+    explicit SpatialHash(float cell_size = 16.f, std::size_t bucket_count = 4096);
+
+    auto insert(const Aabb& box, uint32_t user) -> ProxyID;
+    void remove(ProxyID proxy);
+    // moves a box, only re-hashing it if it changed cells
+    void update(ProxyID proxy, const Aabb& box);
+    // replaces the content with boxes[i] for user i, proxy i. cheaper than
+    // updating everything when most boxes moved, e.g. once per tick.
+    void rebuild(Span<const Aabb> boxes);
+    void clear();
+
+    // calls fn(user) once for every box overlapping the query box
+    template <typename Fn>
+    void query(const Aabb& box, Fn&& fn) const;
+
+    auto box(ProxyID proxy) const -> const Aabb& { return m_proxies[proxy].box; }
+    auto size() const -> std::size_t { return m_size; }
+    auto cellSize() const -> float { return m_cell_size; }
+
+private:
+    struct CellRange {
+        int32_t x0, y0, x1, y1;
+
+        auto operator==(const CellRange& other) const -> bool {
+            return x0 == other.x0 && y0 == other.y0 && x1 == other.x1 && y1 == other.y1;
+        }
+    };
+    struct Proxy {
+        Aabb box;
+        CellRange cells;
+        uint32_t user = 0;
+        bool alive = false;
+    };
+    // one per covered cell; cells sharing a bucket are told apart by their coordinates
+    struct Entry {
+        int32_t x, y;
+        ProxyID proxy;
+    };
+
+    auto cellsOf(const Aabb& box) const -> CellRange;
+    auto bucketOf(int32_t x, int32_t y) const -> std::size_t {
+        auto hash = static_cast<uint32_t>(x) * 73856093u ^ static_cast<uint32_t>(y) * 19349663u;
+        return hash & m_bucket_mask;
+    }
+    void link(ProxyID proxy);
+    void unlink(ProxyID proxy);
+
+    float m_cell_size;
+    float m_inv_cell_size;
+    std::size_t m_bucket_mask;
+    std::vector<std::vector<Entry>> m_buckets;
+    std::vector<Proxy> m_proxies;
+    std::vector<ProxyID> m_free;
+    std::size_t m_size = 0;
+};
+
+template <typename Fn>
+void SpatialHash::query(const Aabb& box, Fn&& fn) const {
+    auto range = cellsOf(box);
+    for (auto y = range.y0; y <= range.y1; ++y) {
+        for (auto x = range.x0; x <= range.x1; ++x) {
+            for (const auto& entry : m_buckets[bucketOf(x, y)]) {
+                if (entry.x != x || entry.y != y)
+                    continue;
+                const auto& proxy = m_proxies[entry.proxy];
+                // a box spanning several query cells is reported from the
+                // first cell both share only
+                if (x != std::max(range.x0, proxy.cells.x0) || y != std::max(range.y0, proxy.cells.y0))
+                    continue;
+                if (proxy.box.overlaps(box))
+                    fn(proxy.user);
+            }
+        }
+    }
+}
+
+} // namespace game::physics
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "core/Resource.hpp"
+#include "core/physics/CollisionGrid.hpp"
+
+namespace game::resources {
+
+// solid tiles of the room's level, compiled from its IntGrid layers at load
+using CollisionGrid = physics::CollisionGrid;
+
+} // namespace game::resources
+
+namespace game {
+
+template <>
+struct ResourceTraits<resources::CollisionGrid> {
+    static constexpr ResourceTypeID id = ResourceType::CollisionGrid;
+    static constexpr const char* name = "CollisionGrid";
+};
+
+} // namespace game
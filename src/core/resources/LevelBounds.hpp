@@ -0,0 +1,30 @@
+#pragma once
+
+#include "common/types.hpp"
+#include "core/Resource.hpp"
+
+namespace game::resources {
+
+// playable area of the room's level, in world units (the LDtk level size)
+struct LevelBounds {
+    float left = 0.f;
+    float top = 0.f;
+    float width = 0.f;
+    float height = 0.f;
+
+    auto contains(float x, float y) const -> bool {
+        return x >= left && x < left + width && y >= top && y < top + height;
+    }
+};
+
+} // namespace game::resources
+
+namespace game {
+
+template <>
+struct ResourceTraits<resources::LevelBounds> {
+    static constexpr ResourceTypeID id = ResourceType::LevelBounds;
+    static constexpr const char* name = "LevelBounds";
+};
+
+} // namespace game
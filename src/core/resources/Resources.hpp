@@ -0,0 +1,7 @@
+#pragma once
+
+// all resources with a fixed ID in ResourceType (types.hpp)
+#include "core/resources/LevelBounds.hpp"
+#include "core/resources/SpawnTable.hpp"
+#include "core/resources/Timers.hpp"
+#include "core/resources/CollisionGrid.hpp"
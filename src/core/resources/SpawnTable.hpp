@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include "common/types.hpp"
+#include "core/Resource.hpp"
+
+namespace game::resources {
+
+// where players (re)spawn, e.g. from the LDtk Player entities
+struct SpawnTable {
+    struct Point {
+        float x = 0.f;
+        float y = 0.f;
+    };
+
+    std::vector<Point> points;
+
+    // spreads players over the points, round robin
+    auto pointFor(PlayerID player) const -> const Point& {
+        if (points.empty())
+            throw std::out_of_range("spawn table is empty");
+        return points[player % points.size()];
+    }
+};
+
+} // namespace game::resources
+
+namespace game {
+
+template <>
+struct ResourceTraits<resources::SpawnTable> {
+    static constexpr ResourceTypeID id = ResourceType::SpawnTable;
+    static constexpr const char* name = "SpawnTable";
+};
+
+} // namespace game
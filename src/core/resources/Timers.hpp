@@ -0,0 +1,22 @@
+#pragma once
+
+#include "core/Resource.hpp"
+#include "core/TimerWheel.hpp"
+
+namespace game::resources {
+
+// the room's scheduled respawns, cooldowns, buff expiries and timeouts. the
+// room advances it once per tick and dispatches the expired batch.
+using Timers = TimerWheel;
+
+} // namespace game::resources
+
+namespace game {
+
+template <>
+struct ResourceTraits<resources::Timers> {
+    static constexpr ResourceTypeID id = ResourceType::Timers;
+    static constexpr const char* name = "Timers";
+};
+
+} // namespace game
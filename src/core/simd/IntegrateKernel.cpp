@@ -0,0 +1,117 @@
+#include "core/simd/IntegrateKernel.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define GAME_SIMD_X86 1
+    #include <immintrin.h>
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #include <intrin.h>
+        #define GAME_TARGET_SSE2
+        #define GAME_TARGET_AVX2
+    #else
+        #define GAME_TARGET_SSE2 __attribute__((target("sse2")))
+        #define GAME_TARGET_AVX2 __attribute__((target("avx2")))
+    #endif
+#endif
+
+namespace game::simd {
+
+void integrateScalar(float* pos, const float* vel, std::size_t count, float dt) {
+    for (std::size_t i = 0; i < count; ++i)
+        pos[i] += vel[i] * dt;
+}
+
+#ifdef GAME_SIMD_X86
+
+GAME_TARGET_SSE2
+void integrateSSE2(float* pos, const float* vel, std::size_t count, float dt) {
+    auto step = _mm_set1_ps(dt);
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        auto p0 = _mm_loadu_ps(pos + i);
+        auto p1 = _mm_loadu_ps(pos + i + 4);
+        auto v0 = _mm_loadu_ps(vel + i);
+        auto v1 = _mm_loadu_ps(vel + i + 4);
+        _mm_storeu_ps(pos + i, _mm_add_ps(p0, _mm_mul_ps(v0, step)));
+        _mm_storeu_ps(pos + i + 4, _mm_add_ps(p1, _mm_mul_ps(v1, step)));
+    }
+    integrateScalar(pos + i, vel + i, count - i, dt);
+}
+
+GAME_TARGET_AVX2
+void integrateAVX2(float* pos, const float* vel, std::size_t count, float dt) {
+    auto step = _mm256_set1_ps(dt);
+    std::size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        auto p0 = _mm256_loadu_ps(pos + i);
+        auto p1 = _mm256_loadu_ps(pos + i + 8);
+        auto v0 = _mm256_loadu_ps(vel + i);
+        auto v1 = _mm256_loadu_ps(vel + i + 8);
+        _mm256_storeu_ps(pos + i, _mm256_add_ps(p0, _mm256_mul_ps(v0, step)));
+        _mm256_storeu_ps(pos + i + 8, _mm256_add_ps(p1, _mm256_mul_ps(v1, step)));
+    }
+    integrateScalar(pos + i, vel + i, count - i, dt);
+}
+
+auto detectIsa() -> Isa {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] >= 7) {
+        __cpuid(info, 1);
+        // AVX2 also needs the OS to save the ymm registers (OSXSAVE + XCR0)
+        bool os_avx = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && (_xgetbv(0) & 0x6) == 0x6;
+        __cpuidex(info, 7, 0);
+        if (os_avx && (info[1] & (1 << 5)))
+            return Isa::AVX2;
+    }
+    return Isa::SSE2;
+#else
+    if (__builtin_cpu_supports("avx2"))
+        return Isa::AVX2;
+    if (__builtin_cpu_supports("sse2"))
+        return Isa::SSE2;
+    return Isa::Scalar;
+#endif
+}
+
+#else
+
+void integrateSSE2(float* pos, const float* vel, std::size_t count, float dt) {
+    integrateScalar(pos, vel, count, dt);
+}
+
+void integrateAVX2(float* pos, const float* vel, std::size_t count, float dt) {
+    integrateScalar(pos, vel, count, dt);
+}
+
+auto detectIsa() -> Isa {
+    return Isa::Scalar;
+}
+
+#endif
+
+auto isaName(Isa isa) -> const char* {
+    switch (isa) {
+        case Isa::SSE2: return "sse2";
+        case Isa::AVX2: return "avx2";
+        default: return "scalar";
+    }
+}
+
+auto integrateKernel(Isa isa) -> IntegrateFn {
+#ifdef GAME_SIMD_X86
+    switch (isa) {
+        case Isa::SSE2: return integrateSSE2;
+        case Isa::AVX2: return integrateAVX2;
+        default: break;
+    }
+#endif
+    return integrateScalar;
+}
+
+void integrate(float* pos, const float* vel, std::size_t count, float dt) {
+    static const auto kernel = integrateKernel(detectIsa());
+    kernel(pos, vel, count, dt);
+}
+
+} // namespace game::simd
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+
+namespace game::simd {
+
+// instruction set used by a kernel, picked at runtime from what the CPU supports
+enum class Isa {
+    Scalar,
+    SSE2,
+    AVX2,
+};
+
+// pos[i] += vel[i] * dt over `count` floats. Position and Velocity columns
+// are {x, y} pairs with the same layout, so a chunk of n entities is passed
+// as 2 * n floats. every path does one multiply and one add per float with
+// no fused multiply-add, so all of them give bit-identical results.
+using IntegrateFn = void (*)(float* pos, const float* vel, std::size_t count, float dt);
+
+void integrateScalar(float* pos, const float* vel, std::size_t count, float dt);
+void integrateSSE2(float* pos, const float* vel, std::size_t count, float dt);
+void integrateAVX2(float* pos, const float* vel, std::size_t count, float dt);
+
+// best instruction set supported by this CPU
+auto detectIsa() -> Isa;
+auto isaName(Isa isa) -> const char*;
+// kernel for the given instruction set, falls back to scalar if it isn't
+// compiled in (e.g. on non-x86 builds)
+auto integrateKernel(Isa isa) -> IntegrateFn;
+
+// dispatches to the kernel for detectIsa(), detected once
+void integrate(float* pos, const float* vel, std::size_t count, float dt);
+
+} // namespace game::simd
@@ -0,0 +1,121 @@
+#include "core/systems/CollisionSystem.hpp"
+
+#include <algorithm>
+
+#include "core/components/CollisionComponent.hpp"
+#include "core/components/PositionComponent.hpp"
+
+namespace game {
+
+using components::CollisionComponent;
+using components::Position;
+
+CollisionSystem::CollisionSystem(float margin) : System("CollisionSystem"), m_tree(margin) {
+    reads<Position, CollisionComponent>();
+    sends<events::CollisionEvent>();
+}
+
+void CollisionSystem::init(World& world) {
+    m_query = &world.query<Position, CollisionComponent>();
+    m_collisions = &world.events<events::CollisionEvent>();
+}
+
+void CollisionSystem::update(World& /*world*/, float /*dt*/) {
+    ++m_updates;
+    m_query->forEachChunk([this](ChunkView view) {
+        auto entities = view.entities();
+        auto positions = view.read<Position>();
+        auto shapes = view.read<CollisionComponent>();
+        for (uint32_t row = 0; row < view.count(); ++row) {
+            auto entity = entities[row];
+            const auto& pos = positions[row];
+            const auto& shape = shapes[row];
+            auto box = physics::Aabb::fromRect(pos.x + shape.offset_x, pos.y + shape.offset_y, shape.width,
+                                               shape.height);
+
+            auto index = entityIndex(entity);
+            if (index >= m_tracked.size())
+                m_tracked.resize(index + 1);
+            auto& tracked = m_tracked[index];
+            if (tracked.entity == entity && tracked.is_static == shape.is_static) {
+                if (!tracked.is_static) {
+                    m_tree.move(tracked.slot, box);
+                }
+                else if (m_static_boxes[tracked.slot] != box) {
+                    m_static_boxes[tracked.slot] = box;
+                    m_static_dirty = true;
+                }
+            }
+            else {
+                // new entity, one reusing the slot of a destroyed one, or a
+                // collider switching between static and moving
+                if (tracked.entity == INVALID_ENTITY)
+                    m_live.push_back(index);
+                else
+                    untrack(tracked);
+                track(tracked, entity, box, shape.is_static);
+            }
+            tracked.seen = m_updates;
+        }
+    });
+
+    // drop the entities destroyed or stripped of their collider since last time
+    for (std::size_t i = 0; i < m_live.size();) {
+        auto& tracked = m_tracked[m_live[i]];
+        if (tracked.seen == m_updates) {
+            ++i;
+            continue;
+        }
+        untrack(tracked);
+        tracked = Tracked{};
+        m_live[i] = m_live.back();
+        m_live.pop_back();
+    }
+
+    if (m_static_dirty) {
+        m_static_bvh.build({m_static_boxes.data(), m_static_boxes.size()});
+        m_static_dirty = false;
+    }
+
+    auto send = [this](EntityID a, EntityID b) { m_collisions->send({std::min(a, b), std::max(a, b)}); };
+    m_tree.forEachPair(send);
+    if (m_static_bvh.empty())
+        return;
+    for (auto index : m_live) {
+        const auto& tracked = m_tracked[index];
+        if (tracked.is_static)
+            continue;
+        m_static_bvh.query(m_tree.box(tracked.slot),
+                           [&](uint32_t slot) { send(tracked.entity, m_static_entities[slot]); });
+    }
+}
+
+void CollisionSystem::track(Tracked& tracked, EntityID entity, const physics::Aabb& box, bool is_static) {
+    tracked.entity = entity;
+    tracked.is_static = is_static;
+    if (!is_static) {
+        tracked.slot = m_tree.insert(box, entity);
+        return;
+    }
+    tracked.slot = static_cast<uint32_t>(m_static_boxes.size());
+    m_static_boxes.push_back(box);
+    m_static_entities.push_back(entity);
+    m_static_dirty = true;
+}
+
+void CollisionSystem::untrack(Tracked& tracked) {
+    if (!tracked.is_static) {
+        m_tree.remove(tracked.slot);
+        return;
+    }
+    // the last static collider takes the freed slot
+    auto last = m_static_entities.back();
+    m_static_boxes[tracked.slot] = m_static_boxes.back();
+    m_static_entities[tracked.slot] = last;
+    m_tracked[entityIndex(last)].slot = tracked.slot;
+    m_static_boxes.pop_back();
+    m_static_entities.pop_back();
+    m_static_dirty = true;
+}
+
+} // namespace game
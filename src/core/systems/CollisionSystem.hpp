@@ -0,0 +1,56 @@
+#pragma once
+
+#include <vector>
+
+#include "core/System.hpp"
+#include "core/events/GameEvents.hpp"
+#include "core/physics/Bvh.hpp"
+#include "core/physics/DynamicTree.hpp"
+
+namespace game {
+
+// broadphase for every entity with a Position and a CollisionComponent,
+// sending a CollisionEvent for every overlapping pair. moving entities are
+// kept in a DynamicTree, whose leaves follow them; static colliders go in a
+// Bvh, rebuilt only when a static collider is added, moved or removed.
+// pairs come from the tree walked against itself plus one Bvh query per
+// moving entity, so two static colliders are never paired.
+class CollisionSystem : public System {
+public:
+    explicit CollisionSystem(float margin = 2.f);
+
+    void init(World& world) override;
+    void update(World& world, float dt) override;
+
+    auto tree() const -> const physics::DynamicTree& { return m_tree; }
+    auto staticBvh() const -> const physics::Bvh& { return m_static_bvh; }
+
+private:
+    struct Tracked {
+        EntityID entity = INVALID_ENTITY;
+        // tree proxy of a moving entity, index into m_static_boxes of a static one
+        uint32_t slot = physics::INVALID_PROXY;
+        // update count the entity was last seen on
+        uint64_t seen = 0;
+        bool is_static = false;
+    };
+
+    void track(Tracked& tracked, EntityID entity, const physics::Aabb& box, bool is_static);
+    void untrack(Tracked& tracked);
+
+    Query* m_query = nullptr;
+    EventQueue<events::CollisionEvent>* m_collisions = nullptr;
+    physics::DynamicTree m_tree;
+    // static colliders, the Bvh user values index them
+    std::vector<physics::Aabb> m_static_boxes;
+    std::vector<EntityID> m_static_entities;
+    physics::Bvh m_static_bvh;
+    bool m_static_dirty = false;
+    // indexed by entityIndex()
+    std::vector<Tracked> m_tracked;
+    // indices of m_tracked in use
+    std::vector<uint32_t> m_live;
+    uint64_t m_updates = 0;
+};
+
+} // namespace game
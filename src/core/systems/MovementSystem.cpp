@@ -0,0 +1,45 @@
+#include "core/systems/MovementSystem.hpp"
+
+#include "core/components/PositionComponent.hpp"
+#include "core/components/VelocityComponent.hpp"
+#include "core/simd/IntegrateKernel.hpp"
+
+namespace game {
+
+using components::Position;
+using components::Velocity;
+
+static_assert(sizeof(Position) == 2 * sizeof(float) && sizeof(Velocity) == 2 * sizeof(float),
+              "the integration kernel treats Position and Velocity columns as float arrays");
+
+MovementSystem::MovementSystem(ThreadPool* pool) : System("MovementSystem"), m_pool(pool) {
+    reads<Velocity>();
+    writes<Position>();
+}
+
+void MovementSystem::init(World& world) {
+    m_query = &world.query<Position, Velocity>();
+}
+
+void MovementSystem::update(World& /*world*/, float dt) {
+    m_query->parallelForEachChunk(m_pool, MIN_GRAIN, [dt](ChunkView view) {
+        auto vel = view.read<Velocity>();
+        uint32_t moving = 0;
+        for (const auto& v : vel)
+            moving += (v.x != 0.f || v.y != 0.f) ? 1u : 0u;
+        // only stamp what moved, so idle entities don't report as changed
+        if (moving == 0)
+            return;
+        if (moving == view.count()) {
+            auto* pos = reinterpret_cast<float*>(view.write<Position>().data());
+            simd::integrate(pos, reinterpret_cast<const float*>(vel.data()), 2 * std::size_t{view.count()}, dt);
+            return;
+        }
+        for (uint32_t row = 0; row < view.count(); ++row) {
+            if (vel[row].x != 0.f || vel[row].y != 0.f)
+                simd::integrate(&view.write<Position>(row).x, &vel[row].x, 2, dt);
+        }
+    });
+}
+
+} // namespace game
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "core/System.hpp"
+
+namespace game {
+
+// integrates Velocity into Position, chunks are split across the pool when
+// the room is large enough
+class MovementSystem : public System {
+public:
+    explicit MovementSystem(ThreadPool* pool = nullptr);
+
+    void init(World& world) override;
+    void update(World& world, float dt) override;
+
+    // entities per task
+    static constexpr std::size_t MIN_GRAIN = 4096;
+
+private:
+    ThreadPool* m_pool;
+    Query* m_query = nullptr;
+};
+
+} // namespace game
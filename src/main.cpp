@@ -1,9 +1,19 @@
+#include <algorithm>
 #include <iostream>
 
 #include <SFML/Graphics.hpp>
 #include <LDtkLoader/Project.hpp>
 
+#include "LevelCollision.hpp"
+#include "LevelPrefabs.hpp"
 #include "TileMap.hpp"
+#include "core/physics/Bvh.hpp"
+#include "core/physics/SpatialHash.hpp"
+#include "core/resources/Resources.hpp"
+
+// IntGrid values the player can't walk through
+const std::vector<SolidTile> SOLID_TILES = {
+    {"Trees_grid", "tree"}, {"Trees_grid", "forest"}, {"Ground_grid", "water"}};
 
 
 auto getPlayerCollider(sf::Shape& player) -> sf::FloatRect {
@@ -16,6 +26,10 @@ auto getPlayerCollider(sf::Shape& player) -> sf::FloatRect {
     return rect;
 }
 
+auto toAabb(const sf::FloatRect& rect) -> game::physics::Aabb {
+    return game::physics::Aabb::fromRect(rect.left, rect.top, rect.width, rect.height);
+}
+
 auto getColliderShape(const sf::FloatRect& rect) -> sf::RectangleShape {
     sf::RectangleShape r;
     r.setSize({rect.width, rect.height});
@@ -28,7 +42,15 @@ struct Game {
     TileMap tilemap;
     sf::RectangleShape player;
 
+    game::World ecs;
+    LevelPrefabs prefabs;
     std::vector<sf::FloatRect> colliders;
+    // colliders by grid cell and in a BVH (the default, F2 switches), user
+    // values are indices into colliders
+    game::physics::SpatialHash collider_grid;
+    game::physics::Bvh collider_bvh;
+    bool use_bvh = true;
+    std::vector<uint32_t> candidates;
     bool show_colliders = false;
 
     sf::View camera;
@@ -48,15 +70,38 @@ struct Game {
         // get Entities layer from level_0
         auto& entities_layer = ldtk_level0.getLayer("Entities");
 
-        // retrieve collider entities from entities layer and store them in the colliders vector
+        // instantiate the collider entities from their prefab, all at once
+        ecs.clear();
+        prefabs.clear();
+        auto collider_entities = prefabs.instantiate(ecs, world, entities_layer, "Collider");
+
+        // and store their bounds in the colliders vector
         colliders.clear();
-        for (ldtk::Entity& col : entities_layer.getEntitiesByName("Collider")) {
-            colliders.emplace_back(
-                (float)col.getPosition().x, (float)col.getPosition().y,
-                (float)col.getSize().x, (float)col.getSize().y
-            );
+        colliders.reserve(collider_entities.size());
+        for (auto entity : collider_entities) {
+            auto& pos = ecs.read<game::components::Position>(entity);
+            auto& shape = ecs.read<game::components::CollisionComponent>(entity);
+            colliders.emplace_back(pos.x + shape.offset_x, pos.y + shape.offset_y, shape.width, shape.height);
         }
 
+        // solid tiles as a bitset in the room, merged into rectangles that
+        // join the colliders
+        auto& tiles = ecs.setResource(compileCollisionGrid(ldtk_level0, SOLID_TILES));
+        auto tile_rects = tiles.solidRects();
+        for (auto& rect : tile_rects)
+            colliders.emplace_back(rect.min_x, rect.min_y, rect.width(), rect.height());
+        std::cout << "Collision grid: " << tiles.solidCount() << " solid cells merged into " << tile_rects.size()
+                  << " colliders" << std::endl;
+
+        // hash them on the level grid, and build the BVH over them
+        std::vector<game::physics::Aabb> boxes;
+        boxes.reserve(colliders.size());
+        for (auto& rect : colliders)
+            boxes.push_back(toAabb(rect));
+        collider_grid = game::physics::SpatialHash(static_cast<float>(world.getDefaultCellSize()));
+        collider_grid.rebuild({boxes.data(), boxes.size()});
+        collider_bvh.build({boxes.data(), boxes.size()});
+
         // get the Player entity, and its 'color' field
         auto& player_ent = entities_layer.getEntitiesByName("Player")[0].get();
         auto& player_color = player_ent.getField<ldtk::Color>("color").value();
@@ -91,9 +136,18 @@ struct Game {
         if (sf::Keyboard::isKeyPressed(sf::Keyboard::Right) || sf::Keyboard::isKeyPressed(sf::Keyboard::D))
             player.move(1.5, 0);
 
-        // do collision checks
+        // do collision checks against the colliders the broadphase finds near
+        // the player, in the colliders order
         auto player_collider = getPlayerCollider(player);
-        for (auto& rect : colliders) {
+        candidates.clear();
+        auto collect = [&](uint32_t index) { candidates.push_back(index); };
+        if (use_bvh)
+            collider_bvh.query(toAabb(player_collider), collect);
+        else
+            collider_grid.query(toAabb(player_collider), collect);
+        std::sort(candidates.begin(), candidates.end());
+        for (auto index : candidates) {
+            auto& rect = colliders[index];
             sf::FloatRect intersect;
             if (player_collider.intersects(rect, intersect)) {
                 if (intersect.width < intersect.height) {
@@ -146,9 +200,11 @@ struct Game {
         target.draw(tilemap.getLayer("Ground"));
         target.draw(tilemap.getLayer("Trees"));
         if (show_colliders) {
-            // draw map colliders
-            for (auto& rect : colliders)
-                target.draw(getColliderShape(rect));
+            // draw the map colliders in view
+            auto center = camera.getCenter();
+            auto size = camera.getSize();
+            sf::FloatRect view(center.x - size.x / 2, center.y - size.y / 2, size.x, size.y);
+            collider_bvh.query(toAabb(view), [&](uint32_t index) { target.draw(getColliderShape(colliders[index])); });
         }
 
         // draw player
@@ -196,6 +252,10 @@ int main() {
             if (event.type == sf::Event::KeyReleased) {
                 if (event.key.code == sf::Keyboard::F1)
                     game.show_colliders = !game.show_colliders;
+                else if (event.key.code == sf::Keyboard::F2) {
+                    game.use_bvh = !game.use_bvh;
+                    std::cout << "Collider broadphase: " << (game.use_bvh ? "BVH" : "grid") << std::endl;
+                }
                 else if (event.key.code == sf::Keyboard::F5) {
                     // reload the LDtk project and reinitialize the game
                     project.loadFromFile(ldtk_filename);